@@ -0,0 +1,60 @@
+# Generate the compiled Material code point table.
+# Run as a script:
+#   cmake -DCODEPOINTS=<codepoints file> -DOUTPUT=<header> -P GenerateCodePoints.cmake
+#
+# The codepoints file has lines of "name hex". The header defines MaterialCodePointTable, an array of
+# CodePointEntry sorted by name for binary search, see CodePointTable.h. If CODEPOINTS is empty or does not
+# exist the table is empty, so the header can always be included.
+
+if (NOT OUTPUT)
+    message(FATAL_ERROR "GenerateCodePoints: OUTPUT is not set")
+endif ()
+
+# Entries are "name hex", a space sorts before any name character so sorting entries sorts names.
+set(NAMES "")
+if (CODEPOINTS AND EXISTS "${CODEPOINTS}")
+    file(STRINGS "${CODEPOINTS}" LINES)
+    foreach (LINE IN LISTS LINES)
+        if (LINE MATCHES "^([A-Za-z0-9_]+) +([0-9a-fA-F]+)$")
+            list(APPEND NAMES "${CMAKE_MATCH_1} ${CMAKE_MATCH_2}")
+        endif ()
+    endforeach ()
+endif ()
+list(SORT NAMES COMPARE STRING CASE SENSITIVE)
+
+# A repeated name keeps its lowest code point.
+set(BODY "")
+set(COUNT 0)
+set(LAST "")
+foreach (ENTRY IN LISTS NAMES)
+    string(REPLACE " " ";" FIELDS "${ENTRY}")
+    list(GET FIELDS 0 NAME)
+    list(GET FIELDS 1 CODE)
+    if (NOT NAME STREQUAL LAST)
+        string(APPEND BODY "            CodePointEntry{\"${NAME}\", 0x${CODE}},\n")
+        math(EXPR COUNT "${COUNT} + 1")
+        set(LAST "${NAME}")
+    endif ()
+endforeach ()
+
+set(CONTENT "// Generated by GenerateCodePoints.cmake from '${CODEPOINTS}', do not edit.
+
+#ifndef ROSE2_MATERIALCODEPOINTTABLE_H
+#define ROSE2_MATERIALCODEPOINTTABLE_H
+
+namespace rose {
+    inline constexpr std::array<CodePointEntry, ${COUNT}> MaterialCodePointTable{
+${BODY}    };
+} // rose
+
+#endif //ROSE2_MATERIALCODEPOINTTABLE_H
+")
+
+# Only touch the header when it changes so dependent sources are not rebuilt.
+if (EXISTS "${OUTPUT}")
+    file(READ "${OUTPUT}" EXISTING)
+    if (EXISTING STREQUAL CONTENT)
+        return()
+    endif ()
+endif ()
+file(WRITE "${OUTPUT}" "${CONTENT}")
@@ -0,0 +1,126 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * AnimatedImage.h Created by Richard Buckley (C) 18/10/26
+ */
+
+/**
+ * @file AnimatedImage.h
+ * @author Richard Buckley <richard.buckley@ieee.org>
+ * @version 1.0
+ * @date 18/10/26
+ * @brief A Gadget that plays an animated GIF file.
+ * @details Frames are decoded one at a time on the Application WorkerPool by a GifDecoder and uploaded into a
+ * small ring of streaming Textures. The ring holds as many frames as fit the frame budget, between MinFrames
+ * and MaxFrames, so the memory used does not depend on the length of the loop. Frames are advanced from the
+ * Application animation signal after the delay given for each frame in the file.
+ */
+
+#ifndef ROSE2_ANIMATEDIMAGE_H
+#define ROSE2_ANIMATEDIMAGE_H
+
+#include <deque>
+#include <filesystem>
+#include <vector>
+#include "Gadget.h"
+#include "GifDecoder.h"
+
+namespace rose {
+
+/**
+ * @class AnimatedImage
+ * @brief Play an animated GIF file.
+ */
+    class AnimatedImage : public Gadget {
+    public:
+        static constexpr std::size_t DefaultFrameBudget = 16 * 1024 * 1024;    ///< Default ring budget in bytes.
+        static constexpr std::size_t MinFrames = 2;     ///< Fewest frames in the ring, the shown frame and the next.
+        static constexpr std::size_t MaxFrames = 8;     ///< Most frames in the ring.
+
+    protected:
+        /**
+         * @struct RingFrame
+         * @brief A decoded frame waiting to be shown, or being shown.
+         */
+        struct RingFrame {
+            Texture texture{};      ///< The uploaded frame.
+            uint32_t delay{};       ///< How long to show the frame in milliseconds.
+        };
+
+        std::filesystem::path mImageFilePath{};
+        std::shared_ptr<GifDecoder> mDecoder{};     ///< The decoder, used by one WorkerPool job at a time.
+        std::size_t mFrameBudget{DefaultFrameBudget};   ///< Ring budget in bytes.
+        std::deque<RingFrame> mFrames{};            ///< The frame being shown followed by the decoded frames.
+        std::vector<Texture> mSpare{};              ///< Textures of shown frames to upload new frames to.
+        bool mDecodeInFlight{false};                ///< True while a frame is being decoded.
+        bool mFinished{false};                      ///< True when the file has no more frames.
+        uint64_t mFrameTick{};                      ///< When the front frame started showing, zero until drawn.
+        uint64_t mGeneration{};                     ///< Incremented when the file changes, stale frames are dropped.
+        Color mPlaceholderColor{};                  ///< The color drawn until the first frame is decoded.
+
+        AnimationProtocol::slot_type mAnimationSlot{};  ///< Connection to the animation signal.
+
+        /// @return The number of frames the ring holds.
+        [[nodiscard]] std::size_t ringSize() const;
+
+        /**
+         * @brief Submit the next frame for decoding if the ring has room.
+         */
+        void requestFrame();
+
+        /**
+         * @brief Receive a decoded frame on the UI thread.
+         * @param decoder The decoder, created by the first job.
+         * @param frame The frame, empty at the end of the file or on error.
+         * @param error Empty, or why the frame could not be decoded.
+         * @param generation The value of mGeneration when the request was made.
+         */
+        void frameReady(const std::shared_ptr<GifDecoder> &decoder, std::optional<GifDecoder::Frame> &frame,
+                        const std::string &error, uint64_t generation);
+
+        /**
+         * @brief Show the next frame when the delay of the current one has passed.
+         * @param ticks The animation signal time in milliseconds.
+         */
+        void advance(uint64_t ticks);
+
+    public:
+        AnimatedImage() = default;
+        explicit AnimatedImage(const std::shared_ptr<Theme>& theme) : Gadget(theme) {
+            mPlaceholderColor = theme->colorShades[ThemeColor::Bottom];
+        }
+        AnimatedImage(const AnimatedImage &) = delete;
+        AnimatedImage(AnimatedImage &&) = default;
+        AnimatedImage &operator=(const AnimatedImage &) = delete;
+        AnimatedImage &operator=(AnimatedImage &&) = default;
+        ~AnimatedImage() override = default;
+
+        void initialize() override;
+
+        /**
+         * @brief Set the image file.
+         * @details Playback of the previous file stops and the new file starts playing when it is next drawn.
+         * @param path The GIF file path.
+         */
+        void setFilePath(const std::filesystem::path &path);
+
+        /**
+         * @brief Set the byte budget of the frame ring.
+         * @param budget The budget in bytes.
+         */
+        [[maybe_unused]] void setFrameBudget(std::size_t budget) { mFrameBudget = budget; }
+
+        bool initialLayout(Context &context) override;
+
+        void draw(Context &context, Point drawLocation) override;
+    };
+
+    inline void setParameter(std::shared_ptr<AnimatedImage>& gadget, const std::filesystem::path& path) {
+        gadget->setFilePath(path);
+    }
+
+} // rose
+
+#endif //ROSE2_ANIMATEDIMAGE_H
@@ -20,6 +20,10 @@
 #include <Theme.h>
 #include <Signals.h>
 #include <TimerTick.h>
+#include <TextureCache.h>
+#include <ImageCache.h>
+#include <FileWatcher.h>
+#include <WorkerPool.h>
 
 namespace rose {
 
@@ -42,14 +46,26 @@ namespace rose {
 
         std::vector<std::shared_ptr<Window>>    mWindows{};     ///< The list of attached Windows.
 
+        TextureCache mTextureCache{};   ///< Textures shared between Gadgets, released before the Windows.
+
+        ImageCache mImageCache{};       ///< Decoded images shared between Gadgets, released before the Windows.
+
         std::weak_ptr<Window> mMouseWindow{};   ///< The Window that currently has the mouse, if any.
 
         std::weak_ptr<Gadget> mMouseGadget{};   ///< The Gadget that currently has the mouse, if any.
 
+        std::weak_ptr<Gadget> mButtonGadget{};  ///< The Gadget that received the last button press, if any.
+
+        std::weak_ptr<Gadget> mTouchGadget{};   ///< The Gadget that received the first finger down, if any.
+
         InputParser mInputParser;   ///< InputParser for the command line arguments.
 
         GraphicsModel mGraphicsModel;   ///< The GraphicsModel abstraction of the SDL library.
 
+        WorkerPool mWorkerPool{};       ///< Background work, joined before the GraphicsModel is destroyed.
+
+        FileWatcher mFileWatcher{mWorkerPool};  ///< File change notification, stopped before the WorkerPool.
+
         Rectangle mWidowSizePos{};      ///< The window size and position.
 
         Event event{};                  ///< The current event.
@@ -61,6 +77,12 @@ namespace rose {
          */
         void basicEventLoop();
 
+        /**
+         * @brief Layout the Windows that need layout.
+         * @details Layout only measures content, rendering is deferred to drawing.
+         */
+        void applicationLayout();
+
         /**
          * @brief Draw the application scene.
          */
@@ -83,6 +105,34 @@ namespace rose {
          */
         bool handleMouseButtonEvent(const SDL_MouseButtonEvent &e);
 
+        /**
+         * @brief Send mouse wheel events to the Gadget under the mouse pointer.
+         * @param e the mouse wheel event.
+         * @return true if handled, false if not.
+         */
+        bool handleMouseWheelEvent(const SDL_MouseWheelEvent &e);
+
+        /**
+         * @brief Send touch events to the Gadget under the first finger down.
+         * @param e the touch finger event.
+         * @return true if handled, false if not.
+         */
+        bool handleFingerTouchEvent(const SDL_TouchFingerEvent &e);
+
+        /**
+         * @brief Send keyboard events to the Window they are addressed to.
+         * @param e the keyboard event.
+         * @return true if handled, false if not.
+         */
+        bool handleKeyboardEvent(const SDL_KeyboardEvent &e);
+
+        /**
+         * @brief Send text input events to the Window they are addressed to.
+         * @param e the text input event.
+         * @return true if handled, false if not.
+         */
+        bool handleTextInputEvent(const SDL_TextInputEvent &e);
+
         /**
          * @brief Find Gadget associated with a mouse motion event.
          * @param point the mouse motion event.
@@ -156,6 +206,31 @@ namespace rose {
          */
         [[maybe_unused]] TimerTick& timer() { return mTimer; }
 
+        /**
+         * @brief Accessor for the application texture cache.
+         * @return A reference to the TextureCache.
+         */
+        TextureCache& textureCache() { return mTextureCache; }
+
+        /**
+         * @brief Accessor for the application image cache.
+         * @return A reference to the ImageCache.
+         */
+        ImageCache& imageCache() { return mImageCache; }
+
+        /**
+         * @brief Accessor for the application file watcher.
+         * @return A reference to the FileWatcher.
+         */
+        FileWatcher& fileWatcher() { return mFileWatcher; }
+
+        /**
+         * @brief Accessor for the application worker pool.
+         * @details Completions of jobs run on the UI thread once each time through the event loop.
+         * @return A reference to the WorkerPool.
+         */
+        WorkerPool& workerPool() { return mWorkerPool; }
+
         /**
          * @return The current value of the needs layout flag.
          */
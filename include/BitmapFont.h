@@ -0,0 +1,134 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * BitmapFont.h Created by Richard Buckley (C) 18/10/26
+ */
+
+/**
+ * @file BitmapFont.h
+ * @author Richard Buckley <richard.buckley@ieee.org>
+ * @version 1.0
+ * @date 18/10/26
+ * @brief Pre-rasterized bitmap fonts read from BDF files.
+ * @details A bitmap font has one size and every glyph is already rasterized, so text is drawn by copying glyphs
+ * from a strip Texture with no FreeType involvement. On small displays without a GPU this avoids the cost of
+ * rendering text with SDL_ttf at startup and on every update.
+ */
+
+#ifndef ROSE2_BITMAPFONT_H
+#define ROSE2_BITMAPFONT_H
+
+#include <Rose.h>
+#include <GraphicsModel.h>
+#include <Surface.h>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace rose {
+
+    /**
+     * @brief Exception thrown when a bitmap font file can not be read.
+     */
+    class BitmapFontException : public std::runtime_error {
+    public:
+        explicit BitmapFontException(const std::string &what_arg) : std::runtime_error(what_arg) {}
+
+        [[maybe_unused]] explicit BitmapFontException(const char *what_arg) : std::runtime_error(what_arg) {}
+    };
+
+    /**
+     * @struct BitmapGlyph
+     * @brief The location and placement of a glyph in a BitmapFont strip.
+     */
+    struct BitmapGlyph {
+        Rectangle rect{};       ///< The glyph rectangle in the strip.
+        Point offset{};         ///< The offset of the glyph from the pen position at the top of the line.
+        int advance{};          ///< The distance to the next pen position.
+    };
+
+    /**
+     * @class BitmapFont
+     * @brief A font of pre-rasterized glyphs.
+     * @details The glyphs are packed into rows of a strip Surface as white pixels with the glyph in the alpha
+     * channel. The strip is uploaded once per renderer, through the Application TextureCache, and tinted when
+     * drawn. Fonts are held in a static cache which outlives every renderer, so no Texture is kept here.
+     */
+    class BitmapFont {
+    public:
+        static constexpr int StripWidth = 1024;     ///< The maximum width of the glyph strip.
+
+    protected:
+        std::unordered_map<char32_t, BitmapGlyph> mGlyphs{};    ///< The glyphs by code point.
+        const BitmapGlyph *mDefaultGlyph{};                     ///< Drawn for code points not in the font.
+        int mAscent{};                                          ///< The height above the base line.
+        int mDescent{};                                         ///< The depth below the base line, positive.
+        Surface mStrip{};                                       ///< The glyph strip.
+        std::string mName{};                                    ///< The font file path.
+
+        /**
+         * @brief Read a BDF file.
+         * @param path The file path.
+         * @throws BitmapFontException
+         */
+        void readBDF(const std::filesystem::path &path);
+
+    public:
+        BitmapFont() = delete;
+        BitmapFont(const BitmapFont&) = delete;
+        BitmapFont(BitmapFont&&) = default;
+        BitmapFont& operator=(const BitmapFont&) = delete;
+        BitmapFont& operator=(BitmapFont&&) = default;
+        ~BitmapFont() = default;
+
+        /**
+         * @brief Constructor. Read a bitmap font file.
+         * @param path The file path.
+         * @throws BitmapFontException
+         */
+        explicit BitmapFont(const std::filesystem::path &path);
+
+        /// @return The font file path, which names the strip Texture in the TextureCache.
+        [[nodiscard]] const std::string &name() const { return mName; }
+
+        /// @return The glyph strip.
+        Surface &strip() { return mStrip; }
+
+        /// @return The line height of the font.
+        [[nodiscard]] int height() const { return mAscent + mDescent; }
+
+        /// @return The height above the base line.
+        [[maybe_unused]] [[nodiscard]] int ascent() const { return mAscent; }
+
+        /**
+         * @brief Find the glyph for a code point.
+         * @param code The code point.
+         * @return The glyph, the font default glyph, or nullptr if there is neither.
+         */
+        [[nodiscard]] const BitmapGlyph *glyph(char32_t code) const;
+
+        /**
+         * @brief Measure UTF8 text.
+         * @param text The text.
+         * @return The size of the text.
+         */
+        [[nodiscard]] Size textSize(std::string_view text) const;
+
+        /**
+         * @brief Draw UTF8 text.
+         * @param context The graphics Context.
+         * @param strip The glyph strip uploaded to the Context renderer.
+         * @param text The text.
+         * @param point The top left of the text.
+         * @param color The text color.
+         */
+        void render(Context &context, Texture &strip, std::string_view text, Point point, const Color &color) const;
+    };
+
+} // rose
+
+#endif //ROSE2_BITMAPFONT_H
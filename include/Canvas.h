@@ -0,0 +1,189 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * Canvas.h Created by Richard Buckley (C) 18/10/26
+ */
+
+/**
+ * @file Canvas.h
+ * @author Richard Buckley <richard.buckley@ieee.org>
+ * @version 1.0
+ * @date 18/10/26
+ * @brief A Gadget for procedural pixel content.
+ * @details The Canvas keeps its pixels in a persistent ARGB8888 buffer which an application callback draws into
+ * through a PixelSpan, on the UI thread or on the WorkerPool. The callback marks the rows it changed and only those
+ * rows are uploaded, with SDL_UpdateTexture on a sub-rectangle, to the back of two streaming Textures, which then
+ * becomes the front. The back Texture is one update behind, so the rows changed by the previous update are
+ * uploaded with the current ones. No Texture is created after the first update unless the canvas size changes.
+ */
+
+#ifndef ROSE2_CANVAS_H
+#define ROSE2_CANVAS_H
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "Gadget.h"
+
+namespace rose {
+
+    namespace param {
+        struct CanvasSize { Size data; };
+    }
+
+    /**
+     * @struct PixelSpan
+     * @brief A view of the Canvas pixel buffer given to the draw callback.
+     */
+    struct PixelSpan {
+        uint32_t *pixels{};         ///< The first pixel of the first row.
+        int pitch{};                ///< Pixels from the start of one row to the start of the next.
+        Size size{};                ///< The canvas size.
+        int dirtyFirst{};           ///< The first changed row.
+        int dirtyLast{};            ///< One past the last changed row, equal to dirtyFirst when nothing changed.
+
+        /// @return The first pixel of a row.
+        [[nodiscard]] uint32_t *row(int y) const { return pixels + static_cast<std::ptrdiff_t>(y) * pitch; }
+
+        /// @return A reference to a pixel.
+        [[nodiscard]] uint32_t &pixel(int x, int y) const { return row(y)[x]; }
+
+        /**
+         * @brief Mark rows as changed so they are uploaded.
+         * @param first The first changed row.
+         * @param last One past the last changed row.
+         */
+        void markDirty(int first, int last) {
+            first = std::max(first, 0);
+            last = std::min(last, size.h);
+            if (first >= last)
+                return;
+            if (dirtyFirst == dirtyLast) {
+                dirtyFirst = first;
+                dirtyLast = last;
+            } else {
+                dirtyFirst = std::min(dirtyFirst, first);
+                dirtyLast = std::max(dirtyLast, last);
+            }
+        }
+
+        /// @brief Mark every row as changed.
+        void markAllDirty() { markDirty(0, size.h); }
+
+        /// @return A Color as an ARGB8888 pixel.
+        static uint32_t map(const Color &color) {
+            auto c = color.sdlColor();
+            return static_cast<uint32_t>(c.a) << 24 | static_cast<uint32_t>(c.r) << 16 |
+                   static_cast<uint32_t>(c.g) << 8 | static_cast<uint32_t>(c.b);
+        }
+    };
+
+/**
+ * @class Canvas
+ * @brief Display pixels drawn by an application callback.
+ */
+    class Canvas : public Gadget {
+    public:
+        /**
+         * @brief The draw callback.
+         * @details The buffer keeps its contents between calls, so the callback need only draw and mark what
+         * changes. Rows that are not marked are not uploaded. A callback run on the WorkerPool must not touch
+         * gadgets or other UI thread state.
+         */
+        using DrawCallback = std::function<void(PixelSpan &span, uint64_t ticks)>;
+
+        static constexpr int PitchAlignment = 16;   ///< Rows start on multiples of this many pixels, 64 bytes.
+
+    protected:
+        using PixelBuffer = std::shared_ptr<std::vector<uint32_t>>;
+
+        Size mCanvasSize{};                 ///< The size of the pixel buffer and Textures.
+        int mPitch{};                       ///< Pixels per buffer row.
+        PixelBuffer mPixels{};              ///< The pixel buffer, shared with a running worker job.
+        std::array<Texture, 2> mTextures{}; ///< The front and back Textures.
+        std::size_t mFront{};               ///< The index of the Texture drawn.
+        int mStaleFirst{};                  ///< The first row of the back Texture that is out of date.
+        int mStaleLast{};                   ///< One past the last row of the back Texture that is out of date.
+        DrawCallback mDrawCallback{};       ///< Draws into the buffer.
+        bool mOnWorker{false};              ///< True to run the callback on the WorkerPool.
+        bool mContinuous{false};            ///< True to run the callback every display frame.
+        bool mUpdateRequested{false};       ///< True to run the callback on the next display frame.
+        bool mUpdateInFlight{false};        ///< True while the callback runs on the WorkerPool.
+        uint64_t mGeneration{};             ///< Incremented when the buffer is replaced, stale results are dropped.
+
+        AnimationProtocol::slot_type mAnimationSlot{};  ///< Connection to the animation signal.
+
+        /**
+         * @brief Run the callback if an update is due.
+         * @param ticks The animation signal time in milliseconds.
+         */
+        void update(uint64_t ticks);
+
+        /**
+         * @brief Upload the changed rows and swap the Textures, on the UI thread.
+         * @param dirtyFirst The first row changed by the callback.
+         * @param dirtyLast One past the last row changed by the callback.
+         * @param generation The value of mGeneration when the callback was started.
+         */
+        void updateDone(int dirtyFirst, int dirtyLast, uint64_t generation);
+
+    public:
+        Canvas() = default;
+        explicit Canvas(const std::shared_ptr<Theme>& theme) : Gadget(theme) {}
+        Canvas(const Canvas &) = delete;
+        Canvas(Canvas &&) = default;
+        Canvas &operator=(const Canvas &) = delete;
+        Canvas &operator=(Canvas &&) = default;
+        ~Canvas() override = default;
+
+        void initialize() override;
+
+        /**
+         * @brief Set the canvas size.
+         * @details A new, transparent, buffer is allocated and the callback is run on the next display frame.
+         * @param size The size in pixels.
+         */
+        void setCanvasSize(const Size &size);
+
+        /**
+         * @brief Set the draw callback.
+         * @param callback The callback.
+         * @param onWorker True to run the callback on the WorkerPool.
+         */
+        void setDrawCallback(DrawCallback callback, bool onWorker = false) {
+            mDrawCallback = std::move(callback);
+            mOnWorker = onWorker;
+            mUpdateRequested = true;
+        }
+
+        /**
+         * @brief Run the callback every display frame.
+         * @param continuous True to run every frame, false to run only when requested.
+         */
+        [[maybe_unused]] void setContinuous(bool continuous) { mContinuous = continuous; }
+
+        /**
+         * @brief Run the callback on the next display frame.
+         */
+        void requestUpdate() { mUpdateRequested = true; }
+
+        bool initialLayout(Context &context) override;
+
+        void draw(Context &context, Point drawLocation) override;
+    };
+
+    inline void setParameter(std::shared_ptr<Canvas>& gadget, param::CanvasSize size) {
+        gadget->setCanvasSize(size.data);
+    }
+
+    inline void setParameter(std::shared_ptr<Canvas>& gadget, Canvas::DrawCallback callback) {
+        gadget->setDrawCallback(std::move(callback));
+    }
+
+} // rose
+
+#endif //ROSE2_CANVAS_H
@@ -0,0 +1,70 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * CodePointTable.h Created by Richard Buckley (C) 18/10/26
+ */
+
+/**
+ * @file CodePointTable.h
+ * @author Richard Buckley <richard.buckley@ieee.org>
+ * @version 1.0
+ * @date 18/10/26
+ * @brief The Material icon code points compiled into the library.
+ * @details The build runs CMakeModules/GenerateCodePoints.cmake over the Material codepoints file named by
+ * ROSE_ICON_CODEPOINTS to generate MaterialCodePointTable.h, a constexpr array sorted by name. Icon names are
+ * found by binary search with no allocation, and a name given as a literal resolves at compile time:
+ * @code
+ * static constexpr auto RocketIcon = materialCodePoint("rocket");
+ * @endcode
+ * Without a codepoints file the table is empty and names are looked up in the file loaded by Material.
+ */
+
+#ifndef ROSE2_CODEPOINTTABLE_H
+#define ROSE2_CODEPOINTTABLE_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace rose {
+
+    /**
+     * @struct CodePointEntry
+     * @brief A code point name and value.
+     */
+    struct CodePointEntry {
+        std::string_view name{};    ///< The code point name.
+        uint32_t code{};            ///< The code point.
+    };
+
+} // rose
+
+#include <MaterialCodePointTable.h>
+
+namespace rose {
+
+    /**
+     * @brief Find a Material code point in the compiled table.
+     * @param name The code point name.
+     * @return The code point, or std::nullopt if the name is not in the table.
+     */
+    constexpr std::optional<uint32_t> materialCodePoint(std::string_view name) {
+        auto found = std::lower_bound(MaterialCodePointTable.begin(), MaterialCodePointTable.end(), name,
+                                      [](const CodePointEntry &entry, std::string_view n) { return entry.name < n; });
+        if (found != MaterialCodePointTable.end() && found->name == name)
+            return found->code;
+        return std::nullopt;
+    }
+
+    /// @return True if code points were compiled into the library.
+    constexpr bool hasMaterialCodePointTable() {
+        return !MaterialCodePointTable.empty();
+    }
+
+} // rose
+
+#endif //ROSE2_CODEPOINTTABLE_H
@@ -0,0 +1,131 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * FileWatcher.h Created by Richard Buckley (C) 18/10/26
+ */
+
+/**
+ * @file FileWatcher.h
+ * @author Richard Buckley <richard.buckley@ieee.org>
+ * @version 1.0
+ * @date 18/10/26
+ * @brief Run a job when a file is rewritten.
+ * @details The directory holding each watched file is watched with inotify for files closed after writing and
+ * files renamed into it, which covers programs that write a file in place and those that write a temporary file
+ * and rename it. A single I/O thread blocks on the inotify descriptor, nothing is polled. When a watched file
+ * changes its job is submitted to the WorkerPool, so the work is done off the UI thread and any completion runs
+ * on the UI thread between frames.
+ */
+
+#ifndef ROSE2_FILEWATCHER_H
+#define ROSE2_FILEWATCHER_H
+
+#include <WorkerPool.h>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace rose {
+
+    /**
+     * @class FileWatcherError
+     * @brief Thrown when inotify can not be used.
+     */
+    class FileWatcherError : public std::runtime_error {
+    public:
+        explicit FileWatcherError(const std::string &what_arg) : std::runtime_error(what_arg) {}
+    };
+
+    /**
+     * @class FileWatcher
+     * @brief Watch files for changes with inotify.
+     */
+    class FileWatcher {
+    public:
+        /**
+         * @struct Watch
+         * @brief A watched file.
+         */
+        struct Watch {
+            std::string name{};             ///< The file name within the watched directory.
+            WorkerPool::Job job{};          ///< Submitted when the file changes.
+        };
+
+        /// Keeps a watch active, the watch ends when the last copy is released.
+        using WatchToken = std::shared_ptr<Watch>;
+
+    protected:
+        /**
+         * @struct Directory
+         * @brief A watched directory.
+         */
+        struct Directory {
+            std::filesystem::path path{};               ///< The directory.
+            std::vector<std::weak_ptr<Watch>> watches{};    ///< The watched files in it.
+        };
+
+        WorkerPool &mWorkerPool;        ///< Where jobs are submitted.
+        int mInotify{-1};               ///< The inotify descriptor, opened by the first watch.
+        int mWakeup{-1};                ///< An eventfd written to stop the I/O thread.
+        std::thread mThread{};          ///< The I/O thread.
+        std::mutex mMutex{};            ///< Protects mDirectories.
+        std::unordered_map<int, Directory> mDirectories{};     ///< Watched directories by inotify watch descriptor.
+
+        /**
+         * @brief Open inotify and start the I/O thread.
+         */
+        void start();
+
+        /**
+         * @brief The I/O thread.
+         */
+        void run();
+
+        /**
+         * @brief Collect the jobs of the live watches of a file, removing expired watches.
+         * @param descriptor The inotify watch descriptor of the directory.
+         * @param name The file name, or empty for every file in the directory.
+         * @return The jobs to submit.
+         */
+        std::vector<WorkerPool::Job> changed(int descriptor, const std::string &name);
+
+    public:
+        FileWatcher() = delete;
+        FileWatcher(const FileWatcher &) = delete;
+        FileWatcher(FileWatcher &&) = delete;
+        FileWatcher &operator=(const FileWatcher &) = delete;
+        FileWatcher &operator=(FileWatcher &&) = delete;
+
+        /**
+         * @brief Constructor.
+         * @details inotify is not opened, nor the I/O thread started, until a file is watched.
+         * @param workerPool The WorkerPool jobs are submitted to. It must outlive the FileWatcher.
+         */
+        explicit FileWatcher(WorkerPool &workerPool) : mWorkerPool(workerPool) {}
+
+        /**
+         * @brief Destructor. Stops the I/O thread.
+         */
+        ~FileWatcher();
+
+        /**
+         * @brief Watch a file.
+         * @details The file need not exist yet.
+         * @param path The file path.
+         * @param job Submitted to the WorkerPool each time the file is closed after writing or renamed into place.
+         * @return The token that keeps the watch active.
+         * @throws FileWatcherError if inotify can not be opened or the directory can not be watched.
+         */
+        WatchToken watch(const std::filesystem::path &path, WorkerPool::Job job);
+    };
+
+} // rose
+
+#endif //ROSE2_FILEWATCHER_H
@@ -22,34 +22,117 @@
 
 #include <SDL2/SDL_ttf.h>
 #include <map>
+#include <mutex>
+#include <unordered_map>
 #include <vector>
 #include <filesystem>
 #include <sstream>
 #include <optional>
 #include <fmt/format.h>
 #include <Rose.h>
+#include <LruCache.h>
+#include <MappedFile.h>
+#include <BitmapFont.h>
 
 namespace rose {
 
+    /**
+     * @brief Remove the cached glyph metrics of a font.
+     * @details Called when a font is closed, before the TTF_Font pointer can be reused.
+     * @param ttfFont The font.
+     */
+    void purgeGlyphMetrics(TTF_Font *ttfFont);
+
+    /**
+     * @brief The lock held while fonts are opened or closed.
+     * @details Fonts may be used on different threads at the same time, but opening and closing them goes
+     * through the FreeType library object shared by every font, so it is serialized by this lock.
+     * @return The lock.
+     */
+    std::mutex& fontLifetimeMutex();
+
     /**
      * @class FontDestroy
      * @brief A functor to destroy a TTF_Font
+     * @details Fonts opened from a MappedFile hold a reference to the mapping, which is released after the
+     * font is closed.
      */
     class FontDestroy {
+    protected:
+        std::shared_ptr<const MappedFile> mFontFile{};      ///< The font file mapping, if any.
+
     public:
+        FontDestroy() = default;
+
+        /**
+         * @brief Constructor.
+         * @param fontFile The font file mapping the font was opened from.
+         */
+        explicit FontDestroy(std::shared_ptr<const MappedFile> fontFile) : mFontFile(std::move(fontFile)) {}
+
         /**
          * @brief Destroy a TTF_Font pointer
          * @param ttfFont the Font pointer
          */
         void operator()(TTF_Font *ttfFont) {
+            purgeGlyphMetrics(ttfFont);
+            std::lock_guard lock{fontLifetimeMutex()};
             TTF_CloseFont(ttfFont);
         }
     };
 
     using FontPointer = std::shared_ptr<TTF_Font>;                  ///< Type for TTF smart pointer
+
+    /**
+     * @brief Open a font at a point size from a file mapping.
+     * @details The font holds a reference to the mapping. This may be called on any thread.
+     * @param fontFile The font file mapping.
+     * @param ptSize The point size.
+     * @return The font, or nullptr on failure.
+     */
+    FontPointer openMappedFont(const std::shared_ptr<MappedFile> &fontFile, int ptSize);
     using FontCacheKey = std::pair<std::string, int>;               ///< Type for TTF cache key
     using FontCacheStore [[maybe_unused]] = std::map<FontCacheKey, FontPointer>;     ///< Type for TTF cache store
 
+    /**
+     * @struct StringHash
+     * @brief A transparent string hash so string keyed hash tables can be searched with a std::string_view.
+     */
+    struct StringHash {
+        using is_transparent = void;
+
+        std::size_t operator()(std::string_view string) const noexcept {
+            return std::hash<std::string_view>{}(string);
+        }
+    };
+
+    /**
+     * @struct FontCacheKeyHash
+     * @brief A transparent hash of a FontCacheKey, or a std::pair<std::string_view,int>.
+     */
+    struct FontCacheKeyHash {
+        using is_transparent = void;
+
+        template<class String>
+        std::size_t operator()(const std::pair<String, int> &key) const noexcept {
+            auto seed = std::hash<std::string_view>{}(std::string_view{key.first});
+            return seed ^ (std::hash<int>{}(key.second) + 0x9e3779b97f4a7c15ULL + (seed << 6u) + (seed >> 2u));
+        }
+    };
+
+    /**
+     * @struct FontCacheKeyEqual
+     * @brief A transparent comparison of font cache keys.
+     */
+    struct FontCacheKeyEqual {
+        using is_transparent = void;
+
+        template<class A, class B>
+        bool operator()(const std::pair<A, int> &a, const std::pair<B, int> &b) const noexcept {
+            return a.second == b.second && std::string_view{a.first} == std::string_view{b.first};
+        }
+    };
+
     /**
      * @brief Get the size of a UTF8 string.
      * @param fontPointer The font to use.
@@ -62,15 +145,126 @@ namespace rose {
         return std::make_tuple(w, h);
     }
 
+    /**
+     * @class FontIndex
+     * @brief A persistent index of font names to font file paths.
+     * @details The index maps the stem of every font file found under a set of root paths to the path of the
+     * file. It is stored under the XDG cache directory along with the modification time of every directory
+     * scanned. When loaded the directory times are compared to the file system, which is much cheaper than
+     * walking the font trees; if any have changed, or there is no stored index, the roots are scanned again
+     * in parallel and the index is rewritten.
+     */
+    class FontIndex {
+    public:
+        static constexpr std::string_view IndexVersion = "rose-font-index 2";  ///< First line of an index file.
+
+        using DirectoryTime = std::pair<std::filesystem::path, std::filesystem::file_time_type>;  ///< Scanned directory.
+
+    protected:
+        std::vector<std::filesystem::path> mRoots{};                        ///< The indexed root paths.
+        std::unordered_map<std::string, std::filesystem::path, StringHash, std::equal_to<>> mFonts{};  ///< Font stem to path.
+        std::vector<DirectoryTime> mDirectories{};                          ///< Every directory scanned.
+        bool mLoaded{false};                                                ///< True when the index is loaded.
+
+        /**
+         * @brief Get the path of the index file for the current roots.
+         * @return The path, or std::nullopt if there is no usable cache directory.
+         */
+        [[nodiscard]] std::optional<std::filesystem::path> indexFilePath() const;
+
+        /**
+         * @brief Read a stored index.
+         * @param indexPath The index file path.
+         * @return True if the index was read, is for the current roots and no directory has changed.
+         */
+        bool readIndex(const std::filesystem::path &indexPath);
+
+        /**
+         * @brief Write the index.
+         * @details The index is written to a temporary file which is renamed over the index file.
+         * @param indexPath The index file path.
+         */
+        void writeIndex(const std::filesystem::path &indexPath) const;
+
+        /**
+         * @brief Scan the roots for font files.
+         * @details The root directories and each of their sub-directories are scanned concurrently by a
+         * small pool of threads. Results are merged in root order so the first root containing a font wins.
+         */
+        void rescan();
+
+    public:
+        FontIndex() = default;
+        FontIndex(const FontIndex&) = delete;
+        FontIndex(FontIndex&&) = default;
+        FontIndex& operator=(const FontIndex&) = delete;
+        FontIndex& operator=(FontIndex&&) = default;
+        ~FontIndex() = default;
+
+        /**
+         * @brief Load the index for a set of root paths, rescanning them if the stored index is stale.
+         * @param roots The root paths.
+         */
+        void load(const std::vector<std::filesystem::path> &roots);
+
+        /// @return True if the index has been loaded.
+        [[nodiscard]] bool loaded() const { return mLoaded; }
+
+        /**
+         * @brief Find the path of a font.
+         * @param fontName The font name, the stem of the font file name.
+         * @return The path to the font file, or std::nullopt if not indexed.
+         */
+        [[nodiscard]] std::optional<std::filesystem::path> find(std::string_view fontName) const {
+            if (auto found = mFonts.find(fontName); found != mFonts.end())
+                return found->second;
+            return std::nullopt;
+        }
+
+        /**
+         * @brief Determine if a path names a font file by its extension.
+         * @details True Type and Open Type fonts with extensions .ttf, .otf, .afm, .t1 and .pfb, and BDF bitmap
+         * fonts, are indexed.
+         * @param path The path.
+         * @return True if the path has a font file extension.
+         */
+        static bool isFontFile(const std::filesystem::path &path);
+
+        /**
+         * @brief Determine if a path names a bitmap font file by its extension.
+         * @param path The path.
+         * @return True if the path has the .bdf extension.
+         */
+        static bool isBitmapFontFile(const std::filesystem::path &path);
+    };
+
     /**
      * @class FontManager
      * @brief Manage requests for Fonts by locating them in a specified set of filesystem paths.
      */
     class FontManager : public std::vector<std::filesystem::path> {
+    public:
+        static constexpr std::size_t FontCountBudget = 32;      ///< Open fonts retained when not in use.
+
     protected:
-        std::map<std::string, std::filesystem::path> mFontPathMap{};  ///< The font file path cache
+        FontIndex mFontIndex{};                                       ///< The font file path index
+
+        /// Font file mappings shared by every size opened from the file.
+        std::unordered_map<std::string, std::weak_ptr<MappedFile>, StringHash, std::equal_to<>> mFontFiles{};
 
-        std::map<FontCacheKey, FontPointer> mFontCache{};             ///< The font cache
+        /// The font cache, each font costs one against FontCountBudget.
+        LruCache<FontCacheKey, TTF_Font, FontCacheKeyHash, FontCacheKeyEqual> mFontCache{FontCountBudget};
+
+        /// Bitmap fonts by name, a nullptr entry records a name that is not a bitmap font.
+        std::unordered_map<std::string, std::shared_ptr<BitmapFont>, StringHash, std::equal_to<>> mBitmapFonts{};
+
+        /**
+         * @brief Open a font at a point size from its shared file mapping.
+         * @param fontPath The path to the font file.
+         * @param ptSize The point size.
+         * @return The font, or nullptr on failure.
+         */
+        FontPointer openFont(const std::filesystem::path &fontPath, int ptSize);
 
     public:
         FontManager() = default;
@@ -107,19 +301,16 @@ namespace rose {
         requires StringLike<String>
         std::optional<std::filesystem::path> locateFont(const std::filesystem::path &path, String fontName) {
             for (auto &p : std::filesystem::recursive_directory_iterator(path)) {
-                if (p.path().stem() == fontName && p.is_regular_file()) {
-                    auto ext = p.path().extension().string();
-                    if (ext == ".ttf" || ext == ".otf" || ext == ".afm" || ext == ".t1" || ext == ".pfb")
-                        return p.path();
-                }
+                if (p.path().stem() == fontName && p.is_regular_file() && FontIndex::isFontFile(p.path()))
+                    return p.path();
             }
             return std::nullopt;
         }
 
         /**
-         * @brief Get a path to a font from the cache or from the filesystem.
-         * @details The font cache is search first, if not found the filesystem is searched using locateFont().
-         * If the font is found on the filesystem it is added to the cache.
+         * @brief Get a path to a font from the font index.
+         * @details The FontIndex for the search paths is loaded on first use, after which finding a font is a
+         * hash table lookup.
          * @tparam String The type of the font name.
          * @param fontName The font name
          * @return std::optional<std::filesystem::path>
@@ -127,23 +318,48 @@ namespace rose {
         template<class String>
         requires StringLike<String>
         std::optional<std::filesystem::path> getFontPath(String fontName) {
-            if (auto found = mFontPathMap.find(fontName); found != mFontPathMap.end())
-                return found->second;
+            if (!mFontIndex.loaded())
+                mFontIndex.load(*this);
 
-            for (auto const &rootPath : *this) {
-                auto fontPath = locateFont(rootPath, fontName);
-                if (fontPath) {
-                    mFontPathMap[fontName] = fontPath.value();
-                    return fontPath;
-                }
-            }
+            return mFontIndex.find(std::string_view{fontName});
+        }
 
-            return std::nullopt;
+        /**
+         * @brief Get the shared memory mapping of a font file.
+         * @details The file is mapped once while any font opened from it is in use.
+         * @param fontPath The path to the font file.
+         * @return The mapping, or nullptr if the file can not be mapped.
+         */
+        std::shared_ptr<MappedFile> mapFontFile(const std::filesystem::path &fontPath);
+
+        /**
+         * @brief Get the shared memory mapping of a font file by font name.
+         * @details Used to open the font on another thread with openMappedFont().
+         * @tparam String The type of fontName.
+         * @param fontName The font name.
+         * @return The mapping, or nullptr if the font is not found or can not be mapped.
+         */
+        template<class String>
+        requires StringLike<String>
+        std::shared_ptr<MappedFile> fontFile(String fontName) {
+            if (auto fontPath = getFontPath(fontName); fontPath)
+                return mapFontFile(fontPath.value());
+            return nullptr;
         }
 
+        /**
+         * @brief Get a bitmap font by name.
+         * @details Bitmap fonts are found through the font index like other fonts, and are loaded once.
+         * @param fontName The font name.
+         * @return The font, or nullptr if the name is not a bitmap font.
+         */
+        std::shared_ptr<BitmapFont> getBitmapFont(std::string_view fontName);
+
         /**
          * @brief Get a pointer to a font specified by name and point size.
-         * @details The filesystem is searched using getFontPath().
+         * @details The font cache is searched without copying the name. If the font is not cached its file is
+         * located with getFontPath() and opened from the shared file mapping. Fonts which are not in use are
+         * closed, least recently used first, when more than FontCountBudget fonts are open.
          * @tparam StringType The type of the font name.
          * @param fontName The font name.
          * @param ptSize The point size.
@@ -151,20 +367,14 @@ namespace rose {
          */
         template<typename StringType>
         FontPointer getFont(StringType fontName, int ptSize) {
-            if (auto found = mFontCache.find(FontCacheKey{fontName, ptSize}); found != mFontCache.end()) {
-                return found->second;
+            std::string_view name{fontName};
+            if (auto found = mFontCache.find(std::pair<std::string_view, int>{name, ptSize}); found) {
+                return found;
             }
 
-            if (auto fontPath = getFontPath(fontName); fontPath) {
-                FontPointer fontPointer{TTF_OpenFont(fontPath.value().c_str(), ptSize), FontDestroy{}};
-                if (fontPointer) {
-                    auto font = mFontCache.emplace(FontCacheKey{fontName, ptSize}, fontPointer);
-                    if (font.second) {
-                        return font.first->second;
-                    }
-                } else {
-                    fmt::print("TTF_OpenFont error: {}\n", SDL_GetError());
-                }
+            if (auto fontPath = getFontPath(name); fontPath && !FontIndex::isBitmapFontFile(fontPath.value())) {
+                if (auto fontPointer = openFont(fontPath.value(), ptSize); fontPointer)
+                    return mFontCache.insert(FontCacheKey{std::string{name}, ptSize}, fontPointer, 1);
             }
 
             return nullptr;
@@ -200,6 +410,27 @@ namespace rose {
             auto fontPointer = mFontManager.getFont(fontName, pointSize);
             return fontPointer;
         }
+
+        /**
+         * @brief Get the shared memory mapping of a font file by font name.
+         * @tparam String The type of fontName.
+         * @param fontName The font name.
+         * @return The mapping, or nullptr if the font is not found or can not be mapped.
+         */
+        template<class String>
+        requires StringLike<String>
+        std::shared_ptr<MappedFile> fontFile(String fontName) {
+            return mFontManager.fontFile(fontName);
+        }
+
+        /**
+         * @brief Get a bitmap font by name.
+         * @param fontName The font name.
+         * @return The font, or nullptr if the name is not a bitmap font.
+         */
+        std::shared_ptr<BitmapFont> getBitmapFont(std::string_view fontName) {
+            return mFontManager.getBitmapFont(fontName);
+        }
     };
 
     /**
@@ -245,28 +476,23 @@ namespace rose {
         GlyphMetrics& operator=(GlyphMetrics&&) = default;
     };
 
-    [[maybe_unused]] inline GlyphMetrics getGlyphMetrics(const FontPointer &font, Uint16 glyph) {
-        GlyphMetrics gm{};
-        if (font) {
-            gm.fontMetrics.fontHeight = TTF_FontHeight(font.get());
-            gm.fontMetrics.fontAscent = TTF_FontAscent(font.get());
-            gm.fontMetrics.fontDescent = TTF_FontDescent(font.get());
-            gm.fontMetrics.fontLineSkip = TTF_FontLineSkip(font.get());
-            TTF_GlyphMetrics(font.get(), glyph, &gm.minX, &gm.maxX, &gm.minY, &gm.maxY, &gm.advance);
-        }
-        return gm;
-    }
+    /**
+     * @brief Get the metrics of a glyph.
+     * @details Metrics are cached per font, repeated requests do not call into SDL_ttf.
+     * @param font The font.
+     * @param glyph The UCS-4 code point of the glyph.
+     * @return The GlyphMetrics, which also carry the FontMetrics of the font.
+     */
+    GlyphMetrics getGlyphMetrics32(const FontPointer &font, Uint32 glyph);
 
-    [[maybe_unused]] inline GlyphMetrics getGlyphMetrics32(const FontPointer &font, Uint32 glyph) {
-        GlyphMetrics gm{};
-        if (font) {
-            gm.fontMetrics.fontHeight = TTF_FontHeight(font.get());
-            gm.fontMetrics.fontAscent = TTF_FontAscent(font.get());
-            gm.fontMetrics.fontDescent = TTF_FontDescent(font.get());
-            gm.fontMetrics.fontLineSkip = TTF_FontLineSkip(font.get());
-            TTF_GlyphMetrics32(font.get(), glyph, &gm.minX, &gm.maxX, &gm.minY, &gm.maxY, &gm.advance);
-        }
-        return gm;
+    /**
+     * @brief Get the metrics of a glyph.
+     * @param font The font.
+     * @param glyph The UCS-2 code point of the glyph.
+     * @return The GlyphMetrics.
+     */
+    [[maybe_unused]] inline GlyphMetrics getGlyphMetrics(const FontPointer &font, Uint16 glyph) {
+        return getGlyphMetrics32(font, glyph);
     }
 
 
@@ -276,10 +276,29 @@ namespace rose {
 
         /**
          * @brief Find a constrained layout for this Gadget.
-         * @details This method is only called when there is insufficient room to render the Gadget.
+         * @details This method is called when initialLayout() of any Gadget in the tree returns true. Managers
+         * pass the constraint, less their padding, on to the Gadgets they manage.
          */
         virtual void constrainedGadgetLayout(Context &, Size) {}
 
+        /**
+         * @brief Test if this Gadget sizes itself from the constraint.
+         * @details Layout managers share the space left by the other Gadgets among those that return true.
+         * @return True if constrainedGadgetLayout() sets the size of this Gadget or one it manages.
+         */
+        [[nodiscard]] virtual bool wantsConstraint() const { return false; }
+
+        /**
+         * @brief Compute the space available inside this Gadget's padding.
+         * @param constraint The space available to the Gadget.
+         * @return The space available to the content of the Gadget.
+         */
+        [[nodiscard]] Size interiorConstraint(const Size &constraint) const {
+            auto &padding = mVisualMetrics.gadgetPadding;
+            return Size{std::max(0, constraint.w - padding.topLeft.x - padding.botRight.x),
+                        std::max(0, constraint.h - padding.topLeft.y - padding.botRight.y)};
+        }
+
         /**
          * @brief Get access to the visual metrics of the Gadget so they may be manipulated directly.
          * @details This should only be done by methods involved in layout management.
@@ -414,6 +433,59 @@ namespace rose {
          */
         virtual bool mouseButtonEvent(const SDL_MouseButtonEvent &e);
 
+        /**
+         * @brief Receive mouse motion events.
+         * @details Motion with a button pressed is sent to the Gadget that received the button press, otherwise
+         * to the Gadget under the mouse pointer. The event is passed up the Gadget tree until it is accepted or a
+         * non-managed Widget is encountered.
+         * @param e the SDL_MouseMotionEvent.
+         * @return true if the event was processed.
+         */
+        virtual bool mouseMotionEvent(const SDL_MouseMotionEvent &e);
+
+        /**
+         * @brief Receive mouse wheel events.
+         * @details Wheel events are sent to the Gadget under the mouse pointer and routed in the same way as mouse
+         * button events.
+         * @param e the SDL_MouseWheelEvent.
+         * @return true if the event was processed.
+         */
+        virtual bool mouseWheelEvent(const SDL_MouseWheelEvent &e);
+
+        /**
+         * @brief Receive touch events.
+         * @details All events of a touch are sent to the Gadget under the first finger down, and routed in the
+         * same way as mouse button events. Finger positions are normalized to the Window.
+         * @param e the SDL_TouchFingerEvent.
+         * @return true if the event was processed.
+         */
+        virtual bool fingerTouchEvent(const SDL_TouchFingerEvent &e);
+
+        /**
+         * @brief Receive keyboard events.
+         * @details Keyboard events are sent to the Gadget at the front of the Window focus chain. No action is
+         * implemented in the Gadget base class, the event is passed up the Gadget tree until it is accepted or a
+         * non-managed Widget is encountered.
+         * @param e the SDL_KeyboardEvent.
+         * @return true if the event was processed.
+         */
+        virtual bool keyboardEvent(const SDL_KeyboardEvent &e);
+
+        /**
+         * @brief Receive text input events.
+         * @details Text input events are routed in the same way as keyboard events.
+         * @param e the SDL_TextInputEvent.
+         * @return true if the event was processed.
+         */
+        virtual bool textInputEvent(const SDL_TextInputEvent &e);
+
+        /**
+         * @brief Notification that the Gadget has gained or lost the keyboard focus.
+         * @details Called on the Gadget at the front of the Window focus chain when the chain changes.
+         * @param focus true if the Gadget gained the focus.
+         */
+        virtual void keyboardFocusEvent(bool) {}
+
         /**
          * @brief Add a decorator function to the list of decorators
          * @param decoratorFunction the decorator function.
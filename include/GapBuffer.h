@@ -0,0 +1,159 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * GapBuffer.h Created by Richard Buckley (C) 18/10/26
+ */
+
+/**
+ * @file GapBuffer.h
+ * @author Richard Buckley <richard.buckley@ieee.org>
+ * @version 1.0
+ * @date 18/10/26
+ * @brief A gap buffer for editing sequences.
+ * @details The unused capacity of the buffer is kept as a gap at the edit position. Inserting or erasing at the
+ * gap is constant time, moving the gap costs the distance it moves. Editing at a caret that moves a short
+ * distance between edits stays cheap however long the buffer grows.
+ */
+
+#ifndef ROSE2_GAPBUFFER_H
+#define ROSE2_GAPBUFFER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace rose {
+
+    /**
+     * @class GapBuffer
+     * @brief A sequence with a movable gap at the edit position.
+     * @tparam T The element type.
+     */
+    template<class T>
+    class GapBuffer {
+    public:
+        static constexpr std::size_t MinimumGap = 64;   ///< The smallest gap left after growing the buffer.
+
+    protected:
+        std::vector<T> mData{};         ///< The storage, including the gap.
+        std::size_t mGapBegin{};        ///< The index of the first element of the gap.
+        std::size_t mGapEnd{};          ///< The index one past the last element of the gap.
+
+        /**
+         * @brief Ensure the gap can hold a number of elements.
+         * @param count The number of elements.
+         */
+        void reserveGap(std::size_t count) {
+            if (mGapEnd - mGapBegin >= count)
+                return;
+
+            auto tail = mData.size() - mGapEnd;
+            auto capacity = std::max(mData.size() * 2, size() + count + MinimumGap);
+            std::vector<T> data(capacity);
+            std::move(mData.begin(), mData.begin() + static_cast<std::ptrdiff_t>(mGapBegin), data.begin());
+            std::move(mData.begin() + static_cast<std::ptrdiff_t>(mGapEnd), mData.end(),
+                      data.end() - static_cast<std::ptrdiff_t>(tail));
+            mGapEnd = capacity - tail;
+            mData = std::move(data);
+        }
+
+    public:
+        GapBuffer() = default;
+        GapBuffer(const GapBuffer&) = default;
+        GapBuffer(GapBuffer&&) noexcept = default;
+        GapBuffer& operator=(const GapBuffer&) = default;
+        GapBuffer& operator=(GapBuffer&&) noexcept = default;
+        ~GapBuffer() = default;
+
+        /// @return The number of elements in the buffer.
+        [[nodiscard]] std::size_t size() const { return mData.size() - (mGapEnd - mGapBegin); }
+
+        /// @return True if the buffer is empty.
+        [[nodiscard]] bool empty() const { return size() == 0; }
+
+        /// @return The position of the gap.
+        [[nodiscard]] std::size_t gapPosition() const { return mGapBegin; }
+
+        /**
+         * @brief Access an element.
+         * @param idx The position of the element, not counting the gap.
+         * @return The element.
+         */
+        const T& operator[](std::size_t idx) const {
+            return mData[idx < mGapBegin ? idx : idx + (mGapEnd - mGapBegin)];
+        }
+
+        /**
+         * @brief Move the gap.
+         * @param position The new position of the gap, clamped to the size of the buffer.
+         */
+        void moveGap(std::size_t position) {
+            position = std::min(position, size());
+            if (position < mGapBegin) {
+                auto count = mGapBegin - position;
+                std::move_backward(mData.begin() + static_cast<std::ptrdiff_t>(position),
+                                   mData.begin() + static_cast<std::ptrdiff_t>(mGapBegin),
+                                   mData.begin() + static_cast<std::ptrdiff_t>(mGapEnd));
+                mGapBegin -= count;
+                mGapEnd -= count;
+            } else if (position > mGapBegin) {
+                auto count = position - mGapBegin;
+                std::move(mData.begin() + static_cast<std::ptrdiff_t>(mGapEnd),
+                          mData.begin() + static_cast<std::ptrdiff_t>(mGapEnd + count),
+                          mData.begin() + static_cast<std::ptrdiff_t>(mGapBegin));
+                mGapBegin += count;
+                mGapEnd += count;
+            }
+        }
+
+        /**
+         * @brief Insert elements.
+         * @tparam Iterator The input iterator type.
+         * @param position The position to insert at.
+         * @param first The first element to insert.
+         * @param last One past the last element to insert.
+         */
+        template<class Iterator>
+        void insert(std::size_t position, Iterator first, Iterator last) {
+            auto count = static_cast<std::size_t>(std::distance(first, last));
+            moveGap(position);
+            reserveGap(count);
+            std::copy(first, last, mData.begin() + static_cast<std::ptrdiff_t>(mGapBegin));
+            mGapBegin += count;
+        }
+
+        /**
+         * @brief Insert an element.
+         * @param position The position to insert at.
+         * @param value The element.
+         */
+        void insert(std::size_t position, const T &value) {
+            moveGap(position);
+            reserveGap(1);
+            mData[mGapBegin++] = value;
+        }
+
+        /**
+         * @brief Erase elements.
+         * @param position The position of the first element to erase.
+         * @param count The number of elements to erase, clamped to the end of the buffer.
+         */
+        void erase(std::size_t position, std::size_t count = 1) {
+            moveGap(position);
+            mGapEnd += std::min(count, mData.size() - mGapEnd);
+        }
+
+        /**
+         * @brief Remove all elements.
+         */
+        void clear() {
+            mGapBegin = 0;
+            mGapEnd = mData.size();
+        }
+    };
+
+} // rose
+
+#endif //ROSE2_GAPBUFFER_H
@@ -0,0 +1,162 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * GifDecoder.h Created by Richard Buckley (C) 18/10/26
+ */
+
+/**
+ * @file GifDecoder.h
+ * @author Richard Buckley <richard.buckley@ieee.org>
+ * @version 1.0
+ * @date 18/10/26
+ * @brief Decode animated GIF files one frame at a time.
+ * @details The file is memory mapped and each call to GifDecoder::next() decodes only the next frame, composed
+ * onto the logical screen according to the disposal method of the frame before it. The memory used is one
+ * logical screen for the canvas, one more for frames that restore to previous, and the frame returned, however
+ * many frames the file holds.
+ */
+
+#ifndef ROSE2_GIFDECODER_H
+#define ROSE2_GIFDECODER_H
+
+#include <Rose.h>
+#include <MappedFile.h>
+#include <Surface.h>
+#include <array>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace rose {
+
+    /**
+     * @class GifDecoderError
+     * @brief Thrown when a GIF file can not be opened or is corrupt.
+     */
+    class GifDecoderError : public std::runtime_error {
+    public:
+        explicit GifDecoderError(const std::string &what_arg) : std::runtime_error(what_arg) {}
+    };
+
+    /**
+     * @class GifDecoder
+     * @brief Streaming GIF decoder.
+     * @details Not thread safe, but may be used from any one thread at a time.
+     */
+    class GifDecoder {
+    public:
+        static constexpr uint32_t DefaultDelay = 100;   ///< Frame delay in ms used for delays shorter than MinimumDelay.
+        static constexpr uint32_t MinimumDelay = 20;    ///< The shortest delay honoured, as browsers do.
+
+        /**
+         * @struct Frame
+         * @brief A composed frame.
+         */
+        struct Frame {
+            Surface image{};        ///< The logical screen in SDL_PIXELFORMAT_ARGB8888.
+            uint32_t delay{};       ///< How long to show the frame in milliseconds.
+        };
+
+    protected:
+        static constexpr int MaxCodes = 4096;   ///< LZW codes are at most 12 bits.
+
+        MappedFile mFile{};                     ///< The file.
+        std::span<const uint8_t> mData{};       ///< The file contents.
+        std::size_t mFirstBlock{};              ///< Offset of the first block after the header.
+        std::size_t mOffset{};                  ///< Offset of the next block.
+        Size mSize{};                           ///< The logical screen size.
+        std::array<uint32_t, 256> mGlobalPalette{};     ///< The global color table as ARGB.
+        int mLoopCount{-1};         ///< NETSCAPE2.0 repeat count, zero repeats forever, -1 when absent.
+        int mLoopsDone{};           ///< The number of times the end of the file has been reached.
+        bool mFramesThisLoop{};     ///< True if a frame has been decoded since the start of the file.
+
+        std::vector<uint32_t> mCanvas{};        ///< The logical screen.
+        std::vector<uint32_t> mPrevious{};      ///< The logical screen saved for restore to previous.
+        std::vector<uint8_t> mIndices{};        ///< The color indices of the frame being decoded.
+
+        int mDisposal{};            ///< Disposal method from the graphic control extension.
+        int mTransparent{-1};       ///< Transparent color index from the graphic control extension, or -1.
+        uint32_t mDelay{};          ///< Delay from the graphic control extension.
+
+        int mLastDisposal{};        ///< Disposal method of the last frame.
+        SDL_Rect mLastRect{};       ///< Area of the last frame.
+
+        std::array<uint16_t, MaxCodes> mPrefix{};      ///< LZW string table prefixes.
+        std::array<uint8_t, MaxCodes> mSuffix{};       ///< LZW string table suffixes.
+        std::array<uint8_t, MaxCodes + 1> mStack{};    ///< LZW string expansion.
+
+        /**
+         * @brief Read a byte, throwing if the file is truncated.
+         */
+        uint8_t byte();
+
+        /**
+         * @brief Read a little endian 16 bit value, throwing if the file is truncated.
+         */
+        uint16_t word();
+
+        /**
+         * @brief Skip data sub-blocks up to and including the terminator.
+         */
+        void skipSubBlocks();
+
+        /**
+         * @brief Read an extension block.
+         */
+        void extension();
+
+        /**
+         * @brief Decode LZW compressed image data into mIndices.
+         * @param minimumCodeSize The LZW minimum code size.
+         */
+        void decompress(int minimumCodeSize);
+
+        /**
+         * @brief Decode an image block and compose it onto the canvas.
+         * @return The composed frame.
+         */
+        Frame image();
+
+    public:
+        GifDecoder() = delete;
+        GifDecoder(const GifDecoder &) = delete;
+        GifDecoder(GifDecoder &&) = default;
+        GifDecoder &operator=(const GifDecoder &) = delete;
+        GifDecoder &operator=(GifDecoder &&) = default;
+        ~GifDecoder() = default;
+
+        /**
+         * @brief Open a GIF file and read its header.
+         * @param path The file path.
+         * @throws GifDecoderError if the file can not be opened or is not a GIF file.
+         */
+        explicit GifDecoder(const std::filesystem::path &path);
+
+        /// @return The logical screen size.
+        [[nodiscard]] Size size() const { return mSize; }
+
+        /// @return The NETSCAPE2.0 repeat count, zero repeats forever, -1 when the file does not loop.
+        [[nodiscard]] int loopCount() const { return mLoopCount; }
+
+        /**
+         * @brief Decode the next frame.
+         * @details At the end of the file decoding starts again from the first frame as many times as the file
+         * asks to be repeated.
+         * @return The frame, or std::nullopt when there are no more frames.
+         * @throws GifDecoderError if the file is corrupt.
+         */
+        std::optional<Frame> next();
+
+        /**
+         * @brief Start again from the first frame.
+         */
+        void rewind();
+    };
+
+} // rose
+
+#endif //ROSE2_GIFDECODER_H
@@ -0,0 +1,134 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * GlyphAtlas.h Created by Richard Buckley (C) 18/10/26
+ */
+
+/**
+ * @file GlyphAtlas.h
+ * @author Richard Buckley <richard.buckley@ieee.org>
+ * @version 1.0
+ * @date 18/10/26
+ * @brief Glyphs of a font packed into shared textures.
+ * @details Each glyph is rasterized once, in white, into a page texture. Text is drawn by copying glyph
+ * rectangles from the pages, tinted with the texture color modulation, so changing a string does not render
+ * anything new.
+ */
+
+#ifndef ROSE2_GLYPHATLAS_H
+#define ROSE2_GLYPHATLAS_H
+
+#include <Rose.h>
+#include <GraphicsModel.h>
+#include <Font.h>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace rose {
+
+    /**
+     * @struct AtlasGlyph
+     * @brief The location of a glyph in a GlyphAtlas.
+     */
+    struct AtlasGlyph {
+        std::size_t page{};     ///< The page holding the glyph.
+        Rectangle rect{};       ///< The glyph rectangle on the page.
+    };
+
+    /**
+     * @class GlyphAtlas
+     * @brief The glyphs of one font, at one size, packed into page textures for one renderer.
+     */
+    class GlyphAtlas {
+    public:
+        static constexpr int MinimumPageSize = 256;     ///< The smallest page size.
+        static constexpr int MaximumPageSize = 2048;    ///< The largest page size.
+        static constexpr int Gutter = 1;                ///< Transparent pixels between glyphs.
+
+    protected:
+        FontPointer mFont{};                ///< The font glyphs are rasterized from.
+        int mPageSize{};                    ///< The width and height of a page.
+        std::vector<Texture> mPages{};      ///< The page textures.
+        Point mCursor{};                    ///< The next free location on the current shelf of the last page.
+        int mShelfHeight{};                 ///< The height of the current shelf.
+        std::unordered_map<uint32_t, std::optional<AtlasGlyph>> mGlyphs{};     ///< Glyphs, empty if not renderable.
+
+        /**
+         * @brief Add an empty page.
+         * @param context The graphics Context.
+         */
+        void addPage(Context &context);
+
+        /**
+         * @brief Reserve space for a glyph.
+         * @param context The graphics Context.
+         * @param size The size of the glyph.
+         * @return The location of the glyph, or std::nullopt if it is larger than a page.
+         */
+        std::optional<AtlasGlyph> allocate(Context &context, Size size);
+
+        /**
+         * @brief Rasterize a glyph and upload it to a page.
+         * @param context The graphics Context.
+         * @param code The code point.
+         * @return The location of the glyph, or std::nullopt if it can not be rendered.
+         */
+        std::optional<AtlasGlyph> rasterize(Context &context, uint32_t code);
+
+    public:
+        GlyphAtlas() = delete;
+
+        /**
+         * @brief Constructor.
+         * @details The page size is chosen from the font height so a page holds a useful number of glyphs.
+         * @param font The font to rasterize glyphs from.
+         */
+        explicit GlyphAtlas(FontPointer font);
+
+        GlyphAtlas(const GlyphAtlas&) = delete;
+        GlyphAtlas(GlyphAtlas&&) = default;
+        GlyphAtlas& operator=(const GlyphAtlas&) = delete;
+        GlyphAtlas& operator=(GlyphAtlas&&) = default;
+        ~GlyphAtlas() = default;
+
+        /**
+         * @brief Get a glyph, rasterizing it on first use.
+         * @param context The graphics Context.
+         * @param code The code point.
+         * @return A pointer to the glyph location, or nullptr if the glyph can not be rendered.
+         */
+        const AtlasGlyph *glyph(Context &context, uint32_t code);
+
+        /**
+         * @brief Rasterize a set of glyphs ahead of use.
+         * @param context The graphics Context.
+         * @param codes The code points.
+         */
+        void preload(Context &context, std::u32string_view codes);
+
+        /**
+         * @brief Draw a glyph.
+         * @param context The graphics Context.
+         * @param glyph The glyph.
+         * @param dst The destination Rectangle, the glyph is scaled to fit.
+         * @param color The color to tint the glyph.
+         */
+        void render(Context &context, const AtlasGlyph &glyph, const Rectangle &dst, const Color &color);
+
+        /// @return The font glyphs are rasterized from.
+        [[nodiscard]] const FontPointer& font() const { return mFont; }
+
+        /// @return The number of pages.
+        [[maybe_unused]] [[nodiscard]] std::size_t pageCount() const { return mPages.size(); }
+
+        /// @return A page Texture.
+        [[maybe_unused]] Texture& page(std::size_t idx) { return mPages.at(idx); }
+    };
+
+} // rose
+
+#endif //ROSE2_GLYPHATLAS_H
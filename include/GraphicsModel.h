@@ -164,6 +164,16 @@ namespace rose {
         }
 
         [[maybe_unused]] int setAlphaMod(float alpha);
+
+        /**
+         * @brief Set the color and alpha modulation of the Texture.
+         * @details The red, green and blue channels are applied with SDL_SetTextureColorMod(), the alpha channel
+         * with SDL_SetTextureAlphaMod(). A Texture holding white coverage on a transparent background is drawn
+         * in the modulation color.
+         * @param color The modulation Color.
+         * @return The return status of the SDL API.
+         */
+        int setColorMod(const Color &color);
     };
 
     /**
@@ -323,6 +333,15 @@ namespace rose {
          */
         void fillRect(const Rectangle &rect) const;
 
+        /**
+         * @brief Determine if any part of a Rectangle would be rendered.
+         * @details The Rectangle is tested against the clip rectangle if one is set, otherwise against the
+         * output size of the current render target.
+         * @param rect The Rectangle.
+         * @return True if the Rectangle intersects the drawable area.
+         */
+        [[nodiscard]] bool isVisible(const Rectangle &rect) const;
+
         /**
          * @brief Render a pixel.
          * @param p The location of the pixel.
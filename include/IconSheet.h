@@ -0,0 +1,137 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * IconSheet.h Created by Richard Buckley (C) 18/10/26
+ */
+
+/**
+ * @file IconSheet.h
+ * @author Richard Buckley <richard.buckley@ieee.org>
+ * @version 1.0
+ * @date 18/10/26
+ * @brief Icons rasterized at build time into a sprite sheet.
+ * @details The IconSheetGen tool renders the icons an application declares into a PNG sheet and writes a
+ * table of where each one is. At run time the sheet is loaded once and icons are copied from it, without
+ * opening the icon font or rendering glyphs.
+ */
+
+#ifndef ROSE2_ICONSHEET_H
+#define ROSE2_ICONSHEET_H
+
+#include <Rose.h>
+#include <GraphicsModel.h>
+#include <Surface.h>
+#include <cstdint>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace rose {
+
+    /**
+     * @brief Exception thrown when an icon sheet can not be read or written.
+     */
+    class IconSheetException : public std::runtime_error {
+    public:
+        explicit IconSheetException(const std::string &what_arg) : std::runtime_error(what_arg) {}
+
+        [[maybe_unused]] explicit IconSheetException(const char *what_arg) : std::runtime_error(what_arg) {}
+    };
+
+    /**
+     * @class IconSheet
+     * @brief A sprite sheet of icons at one point size.
+     * @details A sheet is a pair of files with a common base path: base.png holds the icons as white pixels with
+     * the glyph in the alpha channel, base.bin holds a Header followed by Header::count Entry records sorted by
+     * code point. Records are written in the byte order of the build host. The sheet is held by a static which
+     * outlives every renderer, so only the Surface is kept here; it is uploaded through the Application
+     * TextureCache.
+     */
+    class IconSheet {
+    public:
+        static constexpr uint32_t Magic = 0x52495348;   ///< "RISH", the first word of the table.
+        static constexpr uint32_t Version = 1;          ///< The table format version.
+
+        /**
+         * @struct Header
+         * @brief The table header.
+         */
+        struct Header {
+            uint32_t magic{Magic};          ///< The table magic number.
+            uint32_t version{Version};      ///< The table format version.
+            uint32_t pointSize{};           ///< The point size the icons were rendered at.
+            uint32_t count{};               ///< The number of entries.
+        };
+
+        /**
+         * @struct Entry
+         * @brief The location of one icon on the sheet.
+         */
+        struct Entry {
+            uint32_t code{};                ///< The icon code point.
+            uint16_t x{}, y{}, w{}, h{};    ///< The icon rectangle on the sheet.
+        };
+
+    protected:
+        int mPointSize{};                   ///< The point size the icons were rendered at.
+        std::vector<Entry> mEntries{};      ///< The icons, sorted by code point.
+        Surface mSheet{};                   ///< The sheet image.
+        std::string mName{};                ///< The sheet base path.
+
+    public:
+        IconSheet() = delete;
+        IconSheet(const IconSheet&) = delete;
+        IconSheet(IconSheet&&) = default;
+        IconSheet& operator=(const IconSheet&) = delete;
+        IconSheet& operator=(IconSheet&&) = default;
+        ~IconSheet() = default;
+
+        /**
+         * @brief Constructor. Load a sheet.
+         * @param basePath The path of the sheet files without extension.
+         * @throws IconSheetException
+         */
+        explicit IconSheet(const std::filesystem::path &basePath);
+
+        /// @return The sheet base path, which names the sheet Texture in the TextureCache.
+        [[nodiscard]] const std::string &name() const { return mName; }
+
+        /// @return The sheet image.
+        Surface &sheet() { return mSheet; }
+
+        /// @return The point size the icons were rendered at.
+        [[nodiscard]] int pointSize() const { return mPointSize; }
+
+        /**
+         * @brief Find an icon.
+         * @param code The icon code point.
+         * @return The icon Entry, or nullptr if the icon is not on the sheet.
+         */
+        [[nodiscard]] const Entry *find(uint32_t code) const;
+
+        /**
+         * @brief Draw an icon at its natural size.
+         * @param context The graphics Context.
+         * @param sheet The sheet uploaded to the Context renderer.
+         * @param entry The icon Entry.
+         * @param point The top left of the icon.
+         * @param color The color to tint the icon.
+         */
+        static void render(Context &context, Texture &sheet, const Entry &entry, Point point, const Color &color);
+
+        /**
+         * @brief Write the table of a sheet.
+         * @param path The table file path.
+         * @param pointSize The point size the icons were rendered at.
+         * @param entries The icons, which are sorted by code point before writing.
+         * @throws IconSheetException
+         */
+        static void writeTable(const std::filesystem::path &path, int pointSize, std::vector<Entry> entries);
+    };
+
+} // rose
+
+#endif //ROSE2_ICONSHEET_H
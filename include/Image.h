@@ -7,8 +7,13 @@
  * @author Richard Buckley <richard.buckley@ieee.org>
  * @version 1.0
  * @date 29/01/23
- * @brief 
- * @details
+ * @brief A Gadget that displays an image file.
+ * @details Image files are decoded on the Application WorkerPool and shared through the Application ImageCache.
+ * Layout space is reserved from the size in the file header, or a declared size, and a placeholder is drawn until
+ * the pixels arrive. The image is decoded at the smallest mip level that covers the space it is drawn in, and
+ * decoded again if that space changes enough to need a different level. A watched file is decoded again each
+ * time it is rewritten, the old image is drawn until the new one is ready. Images decoded on an earlier run are
+ * mapped from the ImageCache PixelStore and uploaded without decoding.
  */
 
 #ifndef ROSE2_IMAGE_H
@@ -17,30 +22,136 @@
 #include <filesystem>
 #include <utility>
 #include "Gadget.h"
+#include "Surface.h"
+#include "ImageCache.h"
+#include "FileWatcher.h"
 
 namespace rose {
 
+    namespace param {
+        struct WatchFile { bool data; };
+    }
+
 /**
  * @class Image
+ * @brief Display an image file, decoded without holding up the UI thread.
  */
     class Image : public Gadget {
     protected:
         std::filesystem::path mImageFilePath{};
-        Texture mTexture{};
+        SharedTexture mTexture{};
+        Size mImageSize{};                  ///< The size reserved for the image by layout.
+        Size mDeclaredSize{};               ///< A size declared by the application, used instead of the header.
+        Size mNaturalSize{};                ///< The size of the image in the file.
+        Size mLevelSize{};                  ///< The mip level size of the Texture drawn or being decoded.
+        Color mPlaceholderColor{};          ///< The color drawn until the image is decoded.
+        bool mDecodeRequested{false};       ///< True when the current file has been submitted for decoding.
+        uint64_t mDecodeGeneration{};       ///< Incremented for each decode request, stale results are dropped.
+        bool mWatchFile{false};             ///< True to reload the image when the file is rewritten.
+        FileWatcher::WatchToken mWatch{};   ///< Keeps the file watch active.
+
+        /**
+         * @brief Watch the image file with the Application FileWatcher.
+         */
+        void startWatch();
+
+        /**
+         * @brief Decode the image file again after it has been rewritten.
+         * @param naturalSize The size read from the new file header, unset if the header is not recognized.
+         */
+        void fileChanged(Size naturalSize);
+
+        /**
+         * @brief Submit the image file for decoding.
+         * @details Without an Application the file is decoded at once by createTexture().
+         * @param context The graphics Context.
+         */
+        void requestDecode(Context &context);
+
+        /**
+         * @brief Receive the result of a PixelStore lookup on the UI thread.
+         * @details A stored image is uploaded, otherwise the file is decoded through the ImageCache and saved.
+         * @param key The image.
+         * @param format The renderer native pixel format the image was looked up in.
+         * @param stored The stored image, if there was one.
+         * @param generation The value of mDecodeGeneration when the request was made.
+         */
+        void storeReady(const ImageKey &key, uint32_t format, const std::optional<StoredImage> &stored,
+                        uint64_t generation);
+
+        /**
+         * @brief Show a Texture taken from, or added to, the ImageCache.
+         * @param texture The Texture.
+         */
+        void textureReady(const SharedTexture &texture);
+
+        /**
+         * @brief Receive a decoded image on the UI thread.
+         * @details The Texture is taken from, or added to, the ImageCache.
+         * @param key The image.
+         * @param surface The decoded image, empty if decoding failed.
+         * @param generation The value of mDecodeGeneration when the request was made.
+         */
+        void imageReady(const ImageKey &key, const ImageCache::SharedSurface &surface, uint64_t generation);
 
     public:
         Image() = default;
-        explicit Image(const std::shared_ptr<Theme>& theme) : Gadget(theme) {}
+        explicit Image(const std::shared_ptr<Theme>& theme) : Gadget(theme) {
+            mPlaceholderColor = theme->colorShades[ThemeColor::Bottom];
+        }
         Image(const Image &) = delete;
         Image(Image &&) = default;
         Image &operator=(const Image &) = delete;
         Image &operator=(Image &&) = default;
         ~Image() override = default;
 
+        /**
+         * @brief Decode the image file and create the Texture on the calling thread.
+         * @param context The graphics Context.
+         */
         void createTexture(Context &context);
 
+        /**
+         * @brief Set the image file.
+         * @details The previous image is discarded and the new file is decoded when the gadget is next drawn.
+         * @param path The image file path.
+         */
         void setFilePath(const std::filesystem::path &path) {
-            mImageFilePath = path;
+            if (mImageFilePath != path) {
+                mImageFilePath = path;
+                mTexture.reset();
+                mImageSize = Size{};
+                mNaturalSize = Size{};
+                mLevelSize = Size{};
+                mWatch.reset();
+                mDecodeRequested = false;
+                ++mDecodeGeneration;
+                setNeedsLayout();
+                setNeedsDrawing();
+            }
+        }
+
+        /**
+         * @brief Declare the size of the image.
+         * @details Layout uses the declared size instead of the size in the file header.
+         * @param size The size.
+         */
+        [[maybe_unused]] void setImageSize(const Size &size) {
+            if (mDeclaredSize != size) {
+                mDeclaredSize = size;
+                setNeedsLayout();
+            }
+        }
+
+        /**
+         * @brief Reload the image when the file is rewritten.
+         * @details The watch starts when the gadget is next drawn.
+         * @param watch True to watch the file.
+         */
+        void setWatchFile(bool watch) {
+            mWatchFile = watch;
+            if (!watch)
+                mWatch.reset();
         }
 
         bool initialLayout(Context &context) override;
@@ -52,6 +163,10 @@ namespace rose {
         gadget->setFilePath(path);
     }
 
+    inline void setParameter(std::shared_ptr<Image>& gadget, param::WatchFile watch) {
+        gadget->setWatchFile(watch.data);
+    }
+
 } // rose
 
 #endif //ROSE2_IMAGE_H
@@ -0,0 +1,223 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * ImageCache.h Created by Richard Buckley (C) 18/10/26
+ */
+
+/**
+ * @file ImageCache.h
+ * @author Richard Buckley <richard.buckley@ieee.org>
+ * @version 1.0
+ * @date 18/10/26
+ * @brief The application level cache of decoded images.
+ * @details Images are identified by file path, modification time and the size they are decoded to, so an
+ * edited file is decoded again and the same file shown at two sizes is two entries. Decoded Surfaces and
+ * uploaded Textures are held in separate least recently used caches, each with a byte budget. Requests for an
+ * image that is already being decoded wait for that decode instead of starting another. Decoded images are also
+ * written to a PixelStore so later runs can upload them without decoding.
+ */
+
+#ifndef ROSE2_IMAGECACHE_H
+#define ROSE2_IMAGECACHE_H
+
+#include <Rose.h>
+#include <GraphicsModel.h>
+#include <Surface.h>
+#include <LruCache.h>
+#include <PixelStore.h>
+#include <TextureCache.h>
+#include <WorkerPool.h>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace rose {
+
+    /**
+     * @struct ImageKey
+     * @brief The attributes which identify a decoded image.
+     */
+    struct ImageKey {
+        std::string path{};         ///< The image file path.
+        int64_t modified{};         ///< The file modification time in file clock ticks.
+        uintmax_t fileSize{};       ///< The file size in bytes when the key was made.
+        int width{};                ///< The width decoded to, zero for the natural size.
+        int height{};               ///< The height decoded to, zero for the natural size.
+
+        bool operator==(const ImageKey &other) const = default;
+
+        /**
+         * @brief Make the key of an image file.
+         * @param path The image file path.
+         * @param size The size to decode to, an unset Size for the natural size.
+         * @return The key, or std::nullopt if the file does not exist.
+         */
+        static std::optional<ImageKey> make(const std::filesystem::path &path, Size size = Size{});
+
+        /// @return The size decoded to, an unset Size for the natural size.
+        [[nodiscard]] Size size() const { return width && height ? Size{width, height} : Size{}; }
+    };
+
+    /**
+     * @struct ImageKeyHash
+     * @brief Hash functor for ImageKey.
+     */
+    struct ImageKeyHash {
+        std::size_t operator()(const ImageKey &key) const noexcept;
+    };
+
+    /**
+     * @struct ImageTextureKey
+     * @brief The attributes which identify an image Texture.
+     */
+    struct ImageTextureKey {
+        SDL_Renderer *renderer{};   ///< The renderer that owns the Texture.
+        ImageKey image{};           ///< The image.
+
+        bool operator==(const ImageTextureKey &other) const = default;
+    };
+
+    /**
+     * @struct ImageTextureKeyHash
+     * @brief Hash functor for ImageTextureKey.
+     */
+    struct ImageTextureKeyHash {
+        std::size_t operator()(const ImageTextureKey &key) const noexcept;
+    };
+
+    /**
+     * @struct ImageCacheStatistics
+     * @brief Counts reported by ImageCache::statistics().
+     */
+    struct ImageCacheStatistics {
+        std::size_t surfaceHits{};      ///< Surface lookups that found the image decoded.
+        std::size_t surfaceMisses{};    ///< Surface lookups that did not.
+        std::size_t textureHits{};      ///< Texture lookups that found the image uploaded.
+        std::size_t textureMisses{};    ///< Texture lookups that did not.
+        std::size_t evictions{};        ///< Surfaces and Textures evicted to meet the budgets.
+        std::size_t decodes{};          ///< Images decoded.
+        std::size_t surfaceBytes{};     ///< Bytes of decoded Surfaces held.
+        std::size_t textureBytes{};     ///< Bytes of Textures held, assuming four bytes per pixel.
+    };
+
+    /**
+     * @class ImageCache
+     * @brief Decoded images shared by every Gadget in the application.
+     * @details Used on the UI thread only, decoding is done on a WorkerPool.
+     */
+    class ImageCache {
+    public:
+        static constexpr std::size_t DefaultSurfaceBudget = 32 * 1024 * 1024;     ///< Default Surface budget in bytes.
+        static constexpr std::size_t DefaultTextureBudget = 64 * 1024 * 1024;     ///< Default Texture budget in bytes.
+
+        using SharedSurface = std::shared_ptr<Surface>;                     ///< A Surface shared through the cache.
+        using SurfaceCallback = std::function<void(const SharedSurface&)>;  ///< Receives a decoded image.
+
+    protected:
+        LruCache<ImageKey, Surface, ImageKeyHash> mSurfaces{DefaultSurfaceBudget};     ///< Decoded images.
+        LruCache<ImageTextureKey, Texture, ImageTextureKeyHash> mTextures{DefaultTextureBudget};  ///< Uploaded images.
+
+        /// Callbacks waiting for images being decoded.
+        std::unordered_map<ImageKey, std::vector<SurfaceCallback>, ImageKeyHash> mPending{};
+
+        std::size_t mDecodes{};         ///< The number of images decoded.
+
+        PixelStore mPixelStore{};       ///< Decoded images kept on disk between runs.
+
+    public:
+        ImageCache() = default;
+        ImageCache(const ImageCache&) = delete;
+        ImageCache(ImageCache&&) = delete;
+        ImageCache& operator=(const ImageCache&) = delete;
+        ImageCache& operator=(ImageCache&&) = delete;
+        ~ImageCache() = default;
+
+        /**
+         * @brief Find an uploaded image.
+         * @param renderer The renderer the Texture is drawn with.
+         * @param key The image.
+         * @return The Texture, or an empty pointer if it is not cached.
+         */
+        SharedTexture findTexture(SDL_Renderer *renderer, const ImageKey &key) {
+            return mTextures.find(ImageTextureKey{renderer, key});
+        }
+
+        /**
+         * @brief Add an uploaded image to the cache.
+         * @param renderer The renderer the Texture belongs to.
+         * @param key The image.
+         * @param texture The Texture.
+         * @return The shared Texture.
+         */
+        SharedTexture insertTexture(SDL_Renderer *renderer, const ImageKey &key, Texture &&texture);
+
+        /**
+         * @brief Find a decoded image.
+         * @param key The image.
+         * @return The Surface, or an empty pointer if it is not cached.
+         */
+        SharedSurface findSurface(const ImageKey &key) { return mSurfaces.find(key); }
+
+        /**
+         * @brief Add a decoded image to the cache.
+         * @param key The image.
+         * @param surface The Surface.
+         * @return The shared Surface.
+         */
+        SharedSurface insertSurface(const ImageKey &key, Surface &&surface);
+
+        /**
+         * @brief Get a decoded image, decoding it on a WorkerPool if it is not cached.
+         * @details If the image is cached the callback is called at once. Otherwise it is called on the UI thread
+         * when the image has been decoded, with an empty pointer if decoding failed.
+         * @param key The image.
+         * @param workerPool The WorkerPool to decode on.
+         * @param callback The callback.
+         * @param storeFormat If not SDL_PIXELFORMAT_UNKNOWN the decoded image is saved to the PixelStore in this
+         * format by the decoding job.
+         */
+        void requestSurface(const ImageKey &key, WorkerPool &workerPool, SurfaceCallback callback,
+                            uint32_t storeFormat = SDL_PIXELFORMAT_UNKNOWN);
+
+        /**
+         * @brief Accessor for the store of decoded images on disk.
+         * @return A reference to the PixelStore.
+         */
+        PixelStore &pixelStore() { return mPixelStore; }
+
+        /**
+         * @brief Remove all Textures owned by a renderer.
+         * @details Called by the Window destructor, before the renderer is destroyed.
+         * @param renderer The renderer.
+         */
+        void purgeRenderer(SDL_Renderer *renderer);
+
+        /**
+         * @brief Set the byte budget of decoded images.
+         * @param budget The budget in bytes.
+         */
+        [[maybe_unused]] void setSurfaceBudget(std::size_t budget) { mSurfaces.setBudget(budget); }
+
+        /**
+         * @brief Set the byte budget of uploaded images.
+         * @param budget The budget in bytes.
+         */
+        [[maybe_unused]] void setTextureBudget(std::size_t budget) { mTextures.setBudget(budget); }
+
+        /// @return The cache statistics.
+        [[nodiscard]] ImageCacheStatistics statistics() const;
+
+        /**
+         * @brief Reset the hit, miss, eviction and decode counts.
+         */
+        [[maybe_unused]] void resetStatistics();
+    };
+
+} // rose
+
+#endif //ROSE2_IMAGECACHE_H
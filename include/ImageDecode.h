@@ -0,0 +1,88 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * ImageDecode.h Created by Richard Buckley (C) 18/10/26
+ */
+
+/**
+ * @file ImageDecode.h
+ * @author Richard Buckley <richard.buckley@ieee.org>
+ * @version 1.0
+ * @date 18/10/26
+ * @brief Image file decoding that is safe to run away from the UI thread.
+ * @details The size of an image is read from the file header without decoding pixels so layout can reserve
+ * space for it. Decoding produces a Surface, which may be done on a WorkerPool thread; the Texture is created
+ * from it on the UI thread. Large images are reduced while decoding by repeated 2x2 box filtering, a mip chain
+ * computed only as far as the level needed, so a Texture is never much larger than the space it is drawn in.
+ */
+
+#ifndef ROSE2_IMAGEDECODE_H
+#define ROSE2_IMAGEDECODE_H
+
+#include <Rose.h>
+#include <Surface.h>
+#include <filesystem>
+#include <optional>
+#include <span>
+
+namespace rose {
+
+    /**
+     * @brief Read the size of an image from the start of the file.
+     * @details PNG, JPEG, GIF and BMP headers are understood. For JPEG the markers are scanned up to the first
+     * start of frame.
+     * @param header The first bytes of the file.
+     * @return The image size, or std::nullopt if the format is not recognized or the header is incomplete.
+     */
+    std::optional<Size> imageHeaderSize(std::span<const uint8_t> header);
+
+    /**
+     * @brief Read the size of an image file without decoding it.
+     * @param path The image file path.
+     * @return The image size, or std::nullopt if it can not be determined.
+     */
+    std::optional<Size> imageFileSize(const std::filesystem::path &path);
+
+    /**
+     * @brief Find the smallest mip level of an image that covers a size.
+     * @details Levels are made by halving each dimension, rounding down, starting at the natural size.
+     * @param natural The natural size of the image.
+     * @param target The size the image is drawn at.
+     * @return The size of the level, the natural size if either argument is unset.
+     */
+    Size mipLevelSize(Size natural, Size target);
+
+    /**
+     * @brief Halve an image with a 2x2 box filter.
+     * @details Each channel of a 32 bit pixel is averaged independently. Images that are not 32 bits per pixel
+     * are converted to SDL_PIXELFORMAT_ARGB8888. Each side is halved rounding down, so an odd last row or column
+     * is dropped, except that a side of one pixel stays one pixel and is averaged with itself.
+     * @param image The image.
+     * @return The next mip level, empty on failure.
+     */
+    Surface halveImage(const Surface &image);
+
+    /**
+     * @brief Reduce an image to a size.
+     * @details The image is halved down to mipLevelSize() and the remaining reduction, which is less than half,
+     * is done with SDL_BlitScaled(). Images are never enlarged.
+     * @param image The image.
+     * @param size The size to reduce to, an unset Size leaves the image unchanged.
+     * @return The reduced image, or the original on failure.
+     */
+    Surface downscaleImage(Surface image, Size size);
+
+    /**
+     * @brief Decode an image file.
+     * @details May be called on any thread.
+     * @param path The image file path.
+     * @param size The size to reduce the image to with downscaleImage(), an unset Size for the natural size.
+     * @return The decoded Surface, empty on failure.
+     */
+    Surface decodeImage(const std::filesystem::path &path, Size size = Size{});
+
+} // rose
+
+#endif //ROSE2_IMAGEDECODE_H
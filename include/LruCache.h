@@ -0,0 +1,209 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * LruCache.h Created by Richard Buckley (C) 18/10/26
+ */
+
+/**
+ * @file LruCache.h
+ * @author Richard Buckley <richard.buckley@ieee.org>
+ * @version 1.0
+ * @date 18/10/26
+ * @brief A least recently used cache of shared resources with a cost budget.
+ * @details Values are held by std::shared_ptr so a resource handed out by the cache stays valid for as long as
+ * any user holds it. A value is in use while a pointer to it is held outside the cache; only values that are not
+ * in use are evicted when the total cost of the cache exceeds the budget.
+ */
+
+#ifndef ROSE2_LRUCACHE_H
+#define ROSE2_LRUCACHE_H
+
+#include <cstddef>
+#include <functional>
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+namespace rose {
+
+    /**
+     * @class LruCache
+     * @brief A least recently used cache of std::shared_ptr values, bounded by a cost budget.
+     * @tparam Key The key type.
+     * @tparam Value The type of the cached resource.
+     * @tparam Hash The hash functor for Key.
+     * @tparam KeyEqual The equality functor for Key.
+     */
+    template<class Key, class Value, class Hash = std::hash<Key>, class KeyEqual = std::equal_to<Key>>
+    class LruCache {
+    public:
+        using value_pointer = std::shared_ptr<Value>;   ///< The type handed out by the cache.
+
+    protected:
+        /**
+         * @struct Entry
+         * @brief A cache entry.
+         */
+        struct Entry {
+            Key key;                ///< The key the entry is stored under.
+            value_pointer value;    ///< The cached value.
+            std::size_t cost;       ///< The cost of the entry counted against the budget.
+        };
+
+        using EntryList = std::list<Entry>;     ///< Entries ordered from most to least recently used.
+
+        EntryList mEntries{};                   ///< The cache entries, most recently used first.
+        std::unordered_map<Key, typename EntryList::iterator, Hash, KeyEqual> mIndex{};    ///< Key to entry index.
+        std::size_t mBudget{};                  ///< The cost budget.
+        std::size_t mCost{};                    ///< The total cost of all entries.
+        std::size_t mHits{};                    ///< The number of find() calls that found a value.
+        std::size_t mMisses{};                  ///< The number of find() calls that did not.
+        std::size_t mEvictions{};               ///< The number of values evicted to meet the budget.
+
+    public:
+        LruCache() = delete;
+
+        /**
+         * @brief Constructor.
+         * @param budget The cost budget.
+         */
+        explicit LruCache(std::size_t budget) : mBudget(budget) {}
+
+        LruCache(const LruCache&) = delete;
+        LruCache(LruCache&&) noexcept = default;
+        LruCache& operator=(const LruCache&) = delete;
+        LruCache& operator=(LruCache&&) noexcept = default;
+        ~LruCache() = default;
+
+        /**
+         * @brief Find a value in the cache.
+         * @details A value that is found becomes the most recently used. If Hash and KeyEqual are transparent
+         * the key may be of any type they accept, which avoids constructing a Key for the lookup.
+         * @tparam K The type of the key to search for.
+         * @param key The key to search for.
+         * @return The value, or an empty pointer if not found.
+         */
+        template<class K>
+        value_pointer find(const K &key) {
+            if (auto itr = mIndex.find(key); itr != mIndex.end()) {
+                ++mHits;
+                mEntries.splice(mEntries.begin(), mEntries, itr->second);
+                return itr->second->value;
+            }
+            ++mMisses;
+            return nullptr;
+        }
+
+        /**
+         * @brief Insert a value into the cache.
+         * @details The value becomes the most recently used, replacing any value stored under the same key. Values
+         * which are not in use are then evicted until the cache is within budget.
+         * @param key The key to store the value under.
+         * @param value The value.
+         * @param cost The cost of the value.
+         * @return The value.
+         */
+        value_pointer insert(const Key &key, value_pointer value, std::size_t cost) {
+            erase(key);
+            mEntries.push_front(Entry{key, value, cost});
+            mIndex.emplace(key, mEntries.begin());
+            mCost += cost;
+            trim();
+            return value;
+        }
+
+        /**
+         * @brief Remove a value from the cache.
+         * @details Users holding the value are unaffected.
+         * @param key The key of the value to remove.
+         */
+        void erase(const Key &key) {
+            if (auto itr = mIndex.find(key); itr != mIndex.end()) {
+                mCost -= itr->second->cost;
+                mEntries.erase(itr->second);
+                mIndex.erase(itr);
+            }
+        }
+
+        /**
+         * @brief Remove all values for which a predicate is true.
+         * @tparam Predicate The predicate type, called with (const Key&, const value_pointer&).
+         * @param predicate The predicate.
+         */
+        template<class Predicate>
+        void eraseIf(Predicate predicate) {
+            for (auto itr = mEntries.begin(); itr != mEntries.end();) {
+                if (predicate(itr->key, itr->value)) {
+                    mCost -= itr->cost;
+                    mIndex.erase(itr->key);
+                    itr = mEntries.erase(itr);
+                } else {
+                    ++itr;
+                }
+            }
+        }
+
+        /**
+         * @brief Evict least recently used values which are not in use until the cache is within budget.
+         */
+        void trim() {
+            for (auto itr = mEntries.end(); mCost > mBudget && itr != mEntries.begin();) {
+                --itr;
+                if (itr->value.use_count() == 1) {
+                    ++mEvictions;
+                    mCost -= itr->cost;
+                    mIndex.erase(itr->key);
+                    itr = mEntries.erase(itr);
+                }
+            }
+        }
+
+        /**
+         * @brief Remove all values from the cache.
+         */
+        void clear() {
+            mIndex.clear();
+            mEntries.clear();
+            mCost = 0;
+        }
+
+        /**
+         * @brief Set the cost budget, evicting values if required.
+         * @param budget The new budget.
+         */
+        void setBudget(std::size_t budget) {
+            mBudget = budget;
+            trim();
+        }
+
+        /// @return The cost budget.
+        [[nodiscard]] std::size_t budget() const { return mBudget; }
+
+        /// @return The total cost of the values in the cache.
+        [[nodiscard]] std::size_t cost() const { return mCost; }
+
+        /// @return The number of values in the cache.
+        [[nodiscard]] std::size_t size() const { return mEntries.size(); }
+
+        /// @return The number of find() calls that found a value.
+        [[nodiscard]] std::size_t hits() const { return mHits; }
+
+        /// @return The number of find() calls that did not find a value.
+        [[nodiscard]] std::size_t misses() const { return mMisses; }
+
+        /// @return The number of values evicted to meet the budget.
+        [[nodiscard]] std::size_t evictions() const { return mEvictions; }
+
+        /**
+         * @brief Reset the hit, miss and eviction counts.
+         */
+        void resetStatistics() {
+            mHits = mMisses = mEvictions = 0;
+        }
+    };
+
+} // rose
+
+#endif //ROSE2_LRUCACHE_H
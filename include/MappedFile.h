@@ -0,0 +1,84 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * MappedFile.h Created by Richard Buckley (C) 18/10/26
+ */
+
+/**
+ * @file MappedFile.h
+ * @author Richard Buckley <richard.buckley@ieee.org>
+ * @version 1.0
+ * @date 18/10/26
+ * @brief Read only memory mapped files.
+ * @details A MappedFile maps the whole of a file into memory. The pages are shared with every other mapping
+ * of the file and are loaded by the kernel as they are touched.
+ */
+
+#ifndef ROSE2_MAPPEDFILE_H
+#define ROSE2_MAPPEDFILE_H
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <stdexcept>
+#include <string>
+
+namespace rose {
+
+    /**
+     * @brief Thrown when a file can not be mapped.
+     */
+    class MappedFileError : public std::runtime_error {
+    public:
+        explicit MappedFileError(const std::string &what_arg) : std::runtime_error(what_arg) {}
+
+        [[maybe_unused]] explicit MappedFileError(const char *what_arg) : std::runtime_error(what_arg) {}
+    };
+
+    /**
+     * @class MappedFile
+     * @brief A read only memory mapping of a file.
+     */
+    class MappedFile {
+    protected:
+        void *mData{nullptr};       ///< The start of the mapping.
+        std::size_t mSize{};        ///< The size of the mapping in bytes.
+
+    public:
+        MappedFile() = default;
+
+        /**
+         * @brief Map a file.
+         * @param path The path to the file.
+         * @throws MappedFileError if the file can not be opened or mapped.
+         */
+        explicit MappedFile(const std::filesystem::path &path);
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile(MappedFile &&other) noexcept;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile& operator=(MappedFile &&other) noexcept;
+
+        /**
+         * @brief Unmap the file.
+         */
+        ~MappedFile();
+
+        /// Test for a valid mapping.
+        explicit operator bool() const noexcept { return mData != nullptr; }
+
+        /// @return A pointer to the start of the mapping.
+        [[nodiscard]] const std::byte *data() const { return static_cast<const std::byte *>(mData); }
+
+        /// @return The size of the mapping in bytes.
+        [[nodiscard]] std::size_t size() const { return mSize; }
+
+        /// @return The mapping as a span of bytes.
+        [[maybe_unused]] [[nodiscard]] std::span<const std::byte> bytes() const { return {data(), mSize}; }
+    };
+
+} // rose
+
+#endif //ROSE2_MAPPEDFILE_H
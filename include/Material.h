@@ -25,11 +25,15 @@
 #include <filesystem>
 #include <vector>
 #include <sstream>
+#include <CodePointTable.h>
 
 namespace rose {
 
     /**
      * @class Material
+     * @brief The Material icon font and the code point names read from its codepoints file.
+     * @details When code points are compiled into the library (see CodePointTable.h) the codepoints file is
+     * not needed and is not read.
      */
     class Material : public std::map<std::string, unsigned int> {
     protected:
@@ -43,7 +47,9 @@ namespace rose {
                 requires StringLike<String1> && StringLike<String2>
         explicit Material(String1 fontSearchPaths, String2 fontName) : mFontManager(fontSearchPaths) {
             mFontName = fontName;
-            std::optional<std::filesystem::path> fontPath = mFontManager.getFontPath(fontName);
+            std::optional<std::filesystem::path> fontPath{};
+            if (!hasMaterialCodePointTable())
+                fontPath = mFontManager.getFontPath(fontName);
             if (fontPath) {
                 fontPath.value().replace_extension("codepoints");
                 fmt::print("{}\n", fontPath.value().string());
@@ -57,6 +63,14 @@ namespace rose {
             auto fontPointer = mFontManager.getFont(mFontName, pointSize);
             return fontPointer;
         }
+
+        /**
+         * @brief Get the shared memory mapping of the icon font file.
+         * @return The mapping, or nullptr if the font is not found or can not be mapped.
+         */
+        std::shared_ptr<MappedFile> fontFile() {
+            return mFontManager.fontFile(mFontName);
+        }
     };
 
 } // rose
@@ -0,0 +1,107 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * NumericText.h Created by Richard Buckley (C) 18/10/26
+ */
+
+/**
+ * @file NumericText.h
+ * @author Richard Buckley <richard.buckley@ieee.org>
+ * @version 1.0
+ * @date 18/10/26
+ * @brief A TextGadget for rapidly changing numeric text.
+ * @details Clocks, counters and meter readouts change several times a second but only use a handful of
+ * characters. NumericText rasterizes the characters of a fixed character set once into a shared GlyphAtlas
+ * and composes the value from those glyphs in fixed width cells. When the value changes only the cells
+ * whose characters changed are redrawn.
+ */
+
+#ifndef ROSE2_NUMERICTEXT_H
+#define ROSE2_NUMERICTEXT_H
+
+#include <TextGadget.h>
+#include <GlyphAtlas.h>
+
+namespace rose {
+
+    /**
+     * @class NumericText
+     * @brief Display text from a small fixed character set in fixed width cells.
+     * @details Characters outside the character set are still displayed, they are added to the GlyphAtlas
+     * when first used, but they may not fit the cell width.
+     */
+    class NumericText : public TextGadget {
+    protected:
+        constexpr static std::string_view ClassName = "NumericText";     ///< NumericText class name.
+
+        std::u32string mCharset{DefaultCharset};    ///< The characters pre-rendered and used to size cells.
+        std::u32string mCells{};                    ///< The code point displayed in each cell.
+        std::shared_ptr<GlyphAtlas> mAtlas{};       ///< The atlas holding the glyphs.
+        Size mCellSize{};                           ///< The size of a cell.
+
+        /**
+         * @brief Compute the cell size from the font metrics of the character set.
+         * @throws TextGadgetException
+         */
+        void measureCells();
+
+        /**
+         * @brief Get the position of a cell relative to the Gadget render rectangle.
+         * @param idx The cell index.
+         * @return The cell Rectangle.
+         */
+        [[nodiscard]] Rectangle cellRectangle(std::size_t idx) const {
+            return Rectangle{mVisualMetrics.renderRect.point.x + static_cast<int>(idx) * mCellSize.w,
+                             mVisualMetrics.renderRect.point.y, mCellSize.w, mCellSize.h};
+        }
+
+        /**
+         * @brief Update the cells from mText.
+         * @details If the number of cells is unchanged the cells which changed are exposed on the Window,
+         * otherwise the Gadget needs layout. Only the cells with new characters are redrawn.
+         */
+        void textChanged() override;
+
+    public:
+        static constexpr std::u32string_view DefaultCharset = U"0123456789+-.,:% ";   ///< The default character set.
+
+        NumericText() = default;
+        explicit NumericText(std::shared_ptr<Theme>& theme) : TextGadget(theme) {}
+        NumericText(const NumericText&) = delete;
+        NumericText(NumericText&&) = default;
+        NumericText& operator = (const NumericText&) = delete;
+        NumericText& operator = (NumericText&&) = default;
+        ~NumericText() override = default;
+
+        const std::string_view& className() const override { return NumericText::ClassName; }
+
+        bool initialLayout(Context &context) override;
+
+        void draw(Context &context, Point drawLocation) override;
+
+        /**
+         * @brief Set the character set.
+         * @param charset The characters to pre-render and size the cells from.
+         */
+        [[maybe_unused]] void setCharset(std::u32string_view charset) {
+            if (mCharset != charset) {
+                mCharset = charset;
+                textUpdated();
+            }
+        }
+    };
+
+    /**
+     * @brief Set the text value on a rose::NumericText
+     * @param gadget Pointer to rose::NumericText.
+     * @param parameter The param::Text value.
+     */
+    inline void setParameter(std::shared_ptr<NumericText>& gadget, const param::Text& parameter) {
+        gadget->setText(parameter.data);
+    }
+
+} // rose
+
+#endif //ROSE2_NUMERICTEXT_H
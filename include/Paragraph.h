@@ -0,0 +1,182 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * Paragraph.h Created by Richard Buckley (C) 18/10/26
+ */
+
+/**
+ * @file Paragraph.h
+ * @author Richard Buckley <richard.buckley@ieee.org>
+ * @version 1.0
+ * @date 18/10/26
+ * @brief A TextGadget that wraps text over multiple lines.
+ * @details The text is wrapped to the width available during constrained layout. Line breaks are computed from
+ * glyph advances without rendering, and are kept between layouts. When the text is edited only the lines from the
+ * first line affected by the edit are wrapped again, stopping as soon as the line breaks fall back into step with
+ * the old breaks. Each line is rendered to its own Texture the first time it is visible, so an edit only renders
+ * the lines it changed.
+ */
+
+#ifndef ROSE2_PARAGRAPH_H
+#define ROSE2_PARAGRAPH_H
+
+#include <TextGadget.h>
+#include <vector>
+
+namespace rose {
+
+    /**
+     * @class Paragraph
+     * @brief Display text wrapped over multiple lines.
+     * @details Lines break at spaces, a newline forces a break and a word too long for a line is broken where it
+     * overflows. If the number of lines is limited the last line is truncated with an ellipsis when the text does
+     * not fit.
+     */
+    class Paragraph : public TextGadget {
+    public:
+        /**
+         * @struct Line
+         * @brief A wrapped line, as byte offsets into the text.
+         */
+        struct Line {
+            std::size_t begin{};            ///< The offset of the first byte of the line.
+            std::size_t end{};              ///< The offset one past the last byte displayed on the line.
+            std::size_t next{};             ///< The offset of the first byte of the next line.
+            std::size_t scanEnd{};          ///< The offset one past the last byte examined to place the break.
+            int width{};                    ///< The width of the line in pixels.
+            /// The offset and width of the line after each code point, used to truncate the line.
+            std::vector<std::pair<std::size_t, int>> stops{};
+            std::size_t shownEnd{};         ///< The end of the displayed text, less than end if truncated.
+            int shownWidth{};               ///< The displayed width including any ellipsis.
+            bool ellipsis{};                ///< True if the line is truncated with an ellipsis.
+            SharedTexture texture{};        ///< The rendered line, created when first visible.
+
+            /**
+             * @brief Move the line by a number of bytes.
+             * @param delta The number of bytes to move.
+             */
+            void shift(std::ptrdiff_t delta);
+        };
+
+    protected:
+        constexpr static std::string_view ClassName = "Paragraph";      ///< Paragraph class name.
+        constexpr static std::string_view Ellipsis = "\xe2\x80\xa6";    ///< The UTF8 ellipsis.
+
+        std::vector<Line> mLines{};         ///< The wrapped lines.
+        std::string mFlowedText{};          ///< The text mLines was wrapped from.
+        int mFlowedWidth{};                 ///< The width mLines was wrapped to.
+        FontPointer mFlowedFont{};          ///< The font mLines was wrapped with.
+        Color mFlowedColor{};               ///< The foreground color of the line textures, if baked.
+        std::size_t mFlowedMaxLines{};      ///< The line limit mLines was wrapped to.
+        int mWrapWidth{};                   ///< The width to wrap the text to.
+        bool mWrapToConstraint{true};       ///< True if mWrapWidth is taken from the layout constraint.
+        std::size_t mMaxLines{};            ///< The maximum number of lines, zero if not limited.
+        int mLineSkip{};                    ///< The distance between lines in pixels.
+        int mEllipsisWidth{};               ///< The width of the ellipsis in pixels.
+
+        /**
+         * @brief Get the advance of a code point in the current font.
+         * @param code The code point.
+         * @return The advance in pixels.
+         */
+        [[nodiscard]] int advance(char32_t code) const;
+
+        /**
+         * @brief Wrap a single line.
+         * @param begin The offset of the first byte of the line.
+         * @return The Line.
+         */
+        [[nodiscard]] Line wrapLine(std::size_t begin) const;
+
+        /**
+         * @brief Bring mLines up to date with the text, wrap width, font and line limit.
+         * @details Lines which end before the first changed byte are kept. Lines are then wrapped until a line
+         * starts at the same place in the unchanged end of the text as an old line did, from which point the old
+         * lines are moved rather than wrapped again.
+         */
+        void reflow();
+
+        /**
+         * @brief Truncate the last line with an ellipsis if the line limit hides some of the text.
+         */
+        void applyEllipsis();
+
+    public:
+        Paragraph() = default;
+        explicit Paragraph(std::shared_ptr<Theme>& theme) : TextGadget(theme) {}
+        Paragraph(const Paragraph&) = delete;
+        Paragraph(Paragraph&&) = default;
+        Paragraph& operator = (const Paragraph&) = delete;
+        Paragraph& operator = (Paragraph&&) = default;
+        ~Paragraph() override = default;
+
+        const std::string_view& className() const override { return Paragraph::ClassName; }
+
+        /**
+         * @brief Wrap the text and compute the desired size.
+         * @param context The graphics Context.
+         * @return True if the wrap width is to be taken from a constrained layout and is not yet known.
+         */
+        bool initialLayout(Context &context) override;
+
+        [[nodiscard]] bool wantsConstraint() const override { return mWrapToConstraint; }
+
+        /**
+         * @brief Set the wrap width from the space available.
+         * @param context The graphics Context.
+         * @param constraint The space available to the Paragraph.
+         */
+        void constrainedGadgetLayout(Context &context, Size constraint) override;
+
+        void draw(Context &context, Point drawLocation) override;
+
+        /**
+         * @brief Set a fixed wrap width.
+         * @details A fixed wrap width does not require a constrained layout.
+         * @param width The width in pixels, or zero to wrap to the space available.
+         */
+        [[maybe_unused]] void setWrapWidth(int width) {
+            if (width <= 0) {
+                // The width is unknown until the next constrained layout.
+                if (mWrapToConstraint)
+                    return;
+                width = 0;
+            }
+            mWrapToConstraint = width == 0;
+            if (mWrapWidth != width) {
+                mWrapWidth = width;
+                setNeedsLayout();
+                setNeedsDrawing();
+            }
+        }
+
+        /**
+         * @brief Set the maximum number of lines.
+         * @param maxLines The maximum number of lines, or zero for no limit.
+         */
+        [[maybe_unused]] void setMaxLines(std::size_t maxLines) {
+            if (mMaxLines != maxLines) {
+                mMaxLines = maxLines;
+                setNeedsLayout();
+                setNeedsDrawing();
+            }
+        }
+
+        /// @return The wrapped lines.
+        [[maybe_unused]] [[nodiscard]] const std::vector<Line>& lines() const { return mLines; }
+    };
+
+    /**
+     * @brief Set the text value on a rose::Paragraph
+     * @param gadget Pointer to rose::Paragraph.
+     * @param parameter The param::Text value.
+     */
+    inline void setParameter(std::shared_ptr<Paragraph>& gadget, const param::Text& parameter) {
+        gadget->setText(parameter.data);
+    }
+
+} // rose
+
+#endif //ROSE2_PARAGRAPH_H
@@ -0,0 +1,148 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * PixelStore.h Created by Richard Buckley (C) 18/10/26
+ */
+
+/**
+ * @file PixelStore.h
+ * @author Richard Buckley <richard.buckley@ieee.org>
+ * @version 1.0
+ * @date 18/10/26
+ * @brief Decoded images kept on disk between runs.
+ * @details Each decoded image is written, in the pixel format the renderer prefers, to a raw file in the Rose
+ * "pixels" directory of the XDG cache. The file is named from the source path, modification time and size
+ * recorded in the ImageKey, the decoded size and the pixel format, so an edited source file is never matched. On a
+ * later run the file is mapped into memory and the pixels are passed to SDL_UpdateTexture as they are, without
+ * decoding or conversion. The store has a byte budget; when it is exceeded the files least recently used are
+ * removed, which also clears out the files left by old versions of watched and remote images.
+ */
+
+#ifndef ROSE2_PIXELSTORE_H
+#define ROSE2_PIXELSTORE_H
+
+#include <GraphicsModel.h>
+#include <MappedFile.h>
+#include <Surface.h>
+#include <atomic>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string_view>
+
+namespace rose {
+
+    struct ImageKey;
+
+    /**
+     * @struct StoredImage
+     * @brief A decoded image mapped from the PixelStore.
+     */
+    struct StoredImage {
+        MappedFile mapping{};       ///< The mapped file.
+        Size size{};                ///< The image size.
+        int pitch{};                ///< Bytes per row.
+        uint32_t format{};          ///< The SDL pixel format.
+
+        /// @return The first pixel.
+        [[nodiscard]] const void *pixels() const;
+    };
+
+    /**
+     * @class PixelStore
+     * @brief Load and save decoded images as raw pixel files.
+     * @details load() and save() may be called from any thread.
+     */
+    class PixelStore {
+    public:
+        static constexpr std::size_t HeaderSize = 64;      ///< Bytes before the pixels, keeping them aligned.
+        static constexpr std::string_view Magic = "RosePix1";  ///< The first bytes of a pixel file.
+        static constexpr std::uintmax_t DefaultBudget = 256 * 1024 * 1024;     ///< Default budget in bytes.
+
+    protected:
+        std::filesystem::path mDirectory{};     ///< The store directory, found on first use.
+        bool mEnabled{true};                    ///< False if the store directory can not be used.
+        std::once_flag mLocate{};               ///< Guards finding the store directory.
+        std::uintmax_t mBudget{DefaultBudget};  ///< The most bytes of pixel files to keep.
+        std::atomic<std::uintmax_t> mBytes{};   ///< Bytes of pixel files in the store, an estimate between prunes.
+        std::mutex mPruneMutex{};               ///< Serializes prune().
+
+        /**
+         * @brief Remove the least recently used pixel files until the store is well under budget.
+         * @details Loading a file marks it used by updating its modification time.
+         */
+        void prune();
+
+        /**
+         * @brief Find the file for an image.
+         * @param key The image.
+         * @param format The SDL pixel format.
+         * @return The path, or std::nullopt if the store can not be used.
+         */
+        std::optional<std::filesystem::path> filePath(const ImageKey &key, uint32_t format);
+
+    public:
+        PixelStore() = default;
+        PixelStore(const PixelStore &) = delete;
+        PixelStore(PixelStore &&) = delete;
+        PixelStore &operator=(const PixelStore &) = delete;
+        PixelStore &operator=(PixelStore &&) = delete;
+        ~PixelStore() = default;
+
+        /**
+         * @brief Constructor.
+         * @param directory Where pixel files are kept, empty for the Rose "pixels" directory in the XDG cache.
+         */
+        explicit PixelStore(std::filesystem::path directory) : mDirectory(std::move(directory)) {}
+
+        /**
+         * @brief Set the byte budget of the store.
+         * @details Call before the store is first used.
+         * @param budget The budget in bytes.
+         */
+        [[maybe_unused]] void setBudget(std::uintmax_t budget) { mBudget = budget; }
+
+        /**
+         * @brief Select the pixel format images are stored in for a renderer.
+         * @details The first format the renderer lists is used if it is a 32 bit format with alpha, otherwise
+         * SDL_PIXELFORMAT_ARGB8888.
+         * @param renderer The renderer.
+         * @return The SDL pixel format.
+         */
+        static uint32_t nativeFormat(SDL_Renderer *renderer);
+
+        /**
+         * @brief Map a stored image.
+         * @details The pages are read in before returning, so the upload on the UI thread does not wait on disk.
+         * @param key The image.
+         * @param format The SDL pixel format.
+         * @return The image, or std::nullopt if it has not been stored.
+         */
+        std::optional<StoredImage> load(const ImageKey &key, uint32_t format);
+
+        /**
+         * @brief Store a decoded image.
+         * @details Nothing is written if the image is already stored, or if the source file no longer matches
+         * the key, which happens when it is rewritten while being decoded. The file is written under a temporary
+         * name and renamed into place.
+         * @param key The image.
+         * @param image The decoded image.
+         * @param format The SDL pixel format to store in.
+         * @return True if the image is stored.
+         */
+        bool save(const ImageKey &key, const Surface &image, uint32_t format);
+
+        /**
+         * @brief Upload a stored image to a new Texture.
+         * @param context The graphics Context.
+         * @param image The stored image.
+         * @return The Texture, empty on error.
+         */
+        static Texture upload(Context &context, const StoredImage &image);
+    };
+
+} // rose
+
+#endif //ROSE2_PIXELSTORE_H
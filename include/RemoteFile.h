@@ -0,0 +1,116 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * RemoteFile.h Created by Richard Buckley (C) 18/10/26
+ */
+
+/**
+ * @file RemoteFile.h
+ * @author Richard Buckley <richard.buckley@ieee.org>
+ * @version 1.0
+ * @date 18/10/26
+ * @brief Keep a local copy of a file served over HTTP.
+ * @details The body is stored in a cache directory, by default the Rose "http" directory in the XDG cache, named
+ * by the FNV-1a hash of the URL. The ETag and Last-Modified values of the response are stored beside it and sent
+ * back as If-None-Match and If-Modified-Since, so a file that has not changed costs a 304 response and nothing
+ * else. The cache directory and URL are parameters so a local server can stand in for the real one.
+ */
+
+#ifndef ROSE2_REMOTEFILE_H
+#define ROSE2_REMOTEFILE_H
+
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace rose {
+
+    /**
+     * @class RemoteFile
+     * @brief Conditional GET of a URL into a cache file.
+     * @details fetch() blocks, it is meant to be run on a WorkerPool. Fetches of one object are serialized, and
+     * files are written under names unique to the fetching thread and renamed into place, so gadgets showing the
+     * same URL can share one object through shared().
+     */
+    class RemoteFile {
+    public:
+        static constexpr long ConnectTimeout = 10;      ///< Seconds to wait for a connection.
+        static constexpr long TransferTimeout = 60;     ///< Seconds to wait for the whole transfer.
+        static constexpr std::string_view MetaVersion = "rose-http-cache 1";   ///< First line of the meta file.
+
+        /**
+         * @enum Status
+         * @brief The outcome of a fetch.
+         */
+        enum class Status {
+            Changed,        ///< A new body was stored.
+            NotModified,    ///< The server reported the cached body is current.
+            Failed,         ///< The request failed, the cached body, if any, is unchanged.
+        };
+
+    protected:
+        std::string mUrl{};                     ///< The URL.
+        std::filesystem::path mBodyPath{};      ///< Where the body is stored.
+        std::filesystem::path mMetaPath{};      ///< Where the validators are stored.
+        std::string mETag{};                    ///< ETag of the stored body.
+        std::string mLastModified{};            ///< Last-Modified of the stored body.
+        bool mMetaLoaded{false};                ///< True once the validators have been read from the meta file.
+        std::mutex mFetchMutex{};               ///< Serializes fetch().
+
+        /**
+         * @brief Read the validators of the stored body.
+         */
+        void loadMeta();
+
+        /**
+         * @brief Write the validators of the stored body.
+         */
+        void saveMeta() const;
+
+    public:
+        RemoteFile() = delete;
+        RemoteFile(const RemoteFile &) = delete;
+        RemoteFile(RemoteFile &&) = delete;
+        RemoteFile &operator=(const RemoteFile &) = delete;
+        RemoteFile &operator=(RemoteFile &&) = delete;
+        ~RemoteFile() = default;
+
+        /**
+         * @brief Constructor.
+         * @param url The URL to fetch.
+         * @param cacheDirectory Where to store the body, empty for the Rose "http" cache directory.
+         * @throws XDGPathError if the default cache directory can not be created.
+         */
+        explicit RemoteFile(std::string url, const std::filesystem::path &cacheDirectory = {});
+
+        /**
+         * @brief Get the RemoteFile of a URL, shared with every other user of the same URL and cache directory.
+         * @param url The URL to fetch.
+         * @param cacheDirectory Where to store the body, empty for the Rose "http" cache directory.
+         * @return The shared RemoteFile.
+         * @throws XDGPathError if the default cache directory can not be created.
+         */
+        static std::shared_ptr<RemoteFile> shared(const std::string &url,
+                                                  const std::filesystem::path &cacheDirectory = {});
+
+        /// @return The URL.
+        [[nodiscard]] const std::string &url() const { return mUrl; }
+
+        /// @return The path of the stored body, which may not exist yet.
+        [[nodiscard]] const std::filesystem::path &bodyPath() const { return mBodyPath; }
+
+        /**
+         * @brief Fetch the URL if it has changed since the stored body was fetched.
+         * @details The body is written to a temporary file and renamed over the stored body only when complete.
+         * @return The outcome.
+         */
+        Status fetch();
+    };
+
+} // rose
+
+#endif //ROSE2_REMOTEFILE_H
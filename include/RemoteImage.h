@@ -0,0 +1,114 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * RemoteImage.h Created by Richard Buckley (C) 18/10/26
+ */
+
+/**
+ * @file RemoteImage.h
+ * @author Richard Buckley <richard.buckley@ieee.org>
+ * @version 1.0
+ * @date 18/10/26
+ * @brief An Image fetched over HTTP.
+ * @details The URL is fetched with a conditional GET on the WorkerPool when the gadget is first connected and
+ * then on a schedule. A body left in the cache by an earlier run is shown at once. A new body is decoded on the
+ * WorkerPool like any other image file, a 304 response leaves the current Texture untouched, there is nothing to
+ * decode or upload. A failed fetch is retried after a short delay which doubles with each failure, up to the
+ * refresh interval.
+ */
+
+#ifndef ROSE2_REMOTEIMAGE_H
+#define ROSE2_REMOTEIMAGE_H
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include "Image.h"
+#include "RemoteFile.h"
+
+namespace rose {
+
+    namespace param {
+        struct Url { std::string data; };
+        struct RefreshInterval { uint64_t data; };
+    }
+
+/**
+ * @class RemoteImage
+ * @brief Display an image fetched from a URL, refreshed on a schedule.
+ */
+    class RemoteImage : public Image {
+    public:
+        static constexpr uint64_t DefaultRefreshInterval = 15 * 60 * 1000;     ///< Default interval, milliseconds.
+        static constexpr uint64_t InitialRetryDelay = 5 * 1000;    ///< Delay after the first failure, milliseconds.
+
+    protected:
+        std::shared_ptr<RemoteFile> mRemote{};      ///< The cached URL, shared by every gadget showing it.
+        std::filesystem::path mCacheDirectory{};    ///< Where bodies are stored, empty for the default.
+        uint64_t mRefreshInterval{DefaultRefreshInterval};  ///< Time between fetches in milliseconds.
+        uint64_t mNextFetch{};                      ///< When the next fetch is due, zero to fetch at once.
+        uint64_t mRetryDelay{InitialRetryDelay};    ///< The delay before retrying after the next failure.
+        bool mFetchInFlight{false};                 ///< True while a fetch is running.
+        uint64_t mFetchGeneration{};                ///< Incremented when the URL changes, stale results are dropped.
+
+        AnimationProtocol::slot_type mAnimationSlot{};  ///< Connection to the animation signal.
+
+        /**
+         * @brief Start a fetch if one is due.
+         * @param ticks The animation signal time in milliseconds.
+         */
+        void refresh(uint64_t ticks);
+
+        /**
+         * @brief Receive the outcome of a fetch on the UI thread.
+         * @param status The outcome.
+         * @param naturalSize The size read from the header of a changed body, unset if it is not recognized.
+         * @param generation The value of mFetchGeneration when the fetch was started.
+         */
+        void fetchDone(RemoteFile::Status status, Size naturalSize, uint64_t generation);
+
+    public:
+        RemoteImage() = default;
+        explicit RemoteImage(const std::shared_ptr<Theme>& theme) : Image(theme) {}
+        RemoteImage(const RemoteImage &) = delete;
+        RemoteImage(RemoteImage &&) = default;
+        RemoteImage &operator=(const RemoteImage &) = delete;
+        RemoteImage &operator=(RemoteImage &&) = default;
+        ~RemoteImage() override = default;
+
+        void initialize() override;
+
+        /**
+         * @brief Set the URL of the image.
+         * @details The cached body, if there is one, is shown until the first fetch completes.
+         * @param url The URL.
+         */
+        void setUrl(const std::string &url);
+
+        /**
+         * @brief Set where fetched bodies are stored.
+         * @details Intended for tests, the default is the Rose "http" directory in the XDG cache.
+         * @param directory The directory.
+         */
+        [[maybe_unused]] void setCacheDirectory(const std::filesystem::path &directory);
+
+        /**
+         * @brief Set the time between fetches.
+         * @param interval The interval in milliseconds.
+         */
+        [[maybe_unused]] void setRefreshInterval(uint64_t interval) { mRefreshInterval = interval; }
+    };
+
+    inline void setParameter(std::shared_ptr<RemoteImage>& gadget, const param::Url& url) {
+        gadget->setUrl(url.data);
+    }
+
+    inline void setParameter(std::shared_ptr<RemoteImage>& gadget, param::RefreshInterval interval) {
+        gadget->setRefreshInterval(interval.data);
+    }
+
+} // rose
+
+#endif //ROSE2_REMOTEIMAGE_H
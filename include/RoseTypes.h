@@ -6,6 +6,8 @@
 #define ROSE2_ROSETYPES_H
 
 #include <array>
+#include <string>
+#include <string_view>
 #include <Signals.h>
 
 namespace rose {
@@ -59,6 +61,13 @@ namespace rose {
      */
     class MultiButtonProtocol : public Protocol<bool, uint32_t, uint64_t> {};
 
+    /**
+     * @class TextEntryProtocol
+     * @brief This protocol sends the text entered into a text field when entry is completed, along with a 64 bit
+     * value of the number of milliseconds since library initialization.
+     */
+    class TextEntryProtocol : public Protocol<std::string, uint64_t> {};
+
     inline std::array<unsigned char, 8> utf8(unsigned int uc) {
         std::array<unsigned char, 8> seq{};
         size_t n = 0;
@@ -104,6 +113,47 @@ namespace rose {
         return seq;
     }
 
+    /**
+     * @brief Decode the UTF-8 code point at a byte offset.
+     * @details A malformed sequence is decoded as U+FFFD.
+     * @param text The UTF-8 string.
+     * @param idx The byte offset of the code point, advanced to the next code point.
+     * @return The code point.
+     */
+    inline char32_t utf8Next(std::string_view text, std::size_t &idx) {
+        auto lead = static_cast<unsigned char>(text[idx]);
+        std::size_t n = lead < 0x80u ? 1 : (lead & 0xe0u) == 0xc0u ? 2 : (lead & 0xf0u) == 0xe0u ? 3 :
+                        (lead & 0xf8u) == 0xf0u ? 4 : 0;
+        if (n == 0 || idx + n > text.size()) {
+            ++idx;
+            return U'\ufffd';
+        }
+
+        char32_t code = n == 1 ? lead : lead & (0x7fu >> n);
+        bool valid = true;
+        for (std::size_t i = 1; i < n; ++i) {
+            auto next = static_cast<unsigned char>(text[idx + i]);
+            valid &= (next & 0xc0u) == 0x80u;
+            code = (code << 6u) | (next & 0x3fu);
+        }
+        idx += valid ? n : 1;
+        return valid ? code : U'\ufffd';
+    }
+
+    /**
+     * @brief Decode a UTF-8 string into code points.
+     * @details Malformed sequences are decoded as U+FFFD.
+     * @param text The UTF-8 string.
+     * @return The code points.
+     */
+    inline std::u32string utf32(std::string_view text) {
+        std::u32string codes{};
+        codes.reserve(text.size());
+        for (std::size_t idx = 0; idx < text.size();)
+            codes.push_back(utf8Next(text, idx));
+        return codes;
+    }
+
 }
 
 #endif //ROSE2_ROSETYPES_H
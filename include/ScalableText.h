@@ -0,0 +1,105 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * ScalableText.h Created by Richard Buckley (C) 18/10/26
+ */
+
+/**
+ * @file ScalableText.h
+ * @author Richard Buckley <richard.buckley@ieee.org>
+ * @version 1.0
+ * @date 18/10/26
+ * @brief A TextGadget that can be drawn at any scale without rendering the text again.
+ * @details Glyphs are rasterized once, at a reference size, into a GlyphAtlas and drawn scaled with linear
+ * filtering. Changing the scale only redraws, so zoom and pulse animations do not open a font for each size
+ * or rasterize any glyphs after the first frame. The reference size should be at least the largest size the
+ * text is drawn at; glyphs drawn larger than the reference size are magnified and soften.
+ */
+
+#ifndef ROSE2_SCALABLETEXT_H
+#define ROSE2_SCALABLETEXT_H
+
+#include <TextGadget.h>
+#include <GlyphAtlas.h>
+
+namespace rose {
+
+    /**
+     * @class ScalableText
+     * @brief Display text drawn from a reference size GlyphAtlas at an arbitrary scale.
+     * @details Layout reserves the size of the text at the gadget point size. The scale set by setScale() is
+     * applied about the center of that space when drawn, without a new layout.
+     */
+    class ScalableText : public TextGadget {
+    public:
+        static constexpr int DefaultReferenceSize = 64;     ///< The default reference point size.
+
+    protected:
+        constexpr static std::string_view ClassName = "ScalableText";     ///< ScalableText class name.
+
+        int mReferenceSize{DefaultReferenceSize};   ///< The point size glyphs are rasterized at.
+        float mScale{1.f};                          ///< The scale applied to the gadget point size when drawn.
+        FontPointer mReferenceFont{};               ///< The font at the reference size.
+        std::string mReferenceFontName{};           ///< The name of mReferenceFont.
+        std::shared_ptr<GlyphAtlas> mAtlas{};       ///< The reference size glyphs.
+        std::u32string mCodes{};                    ///< The code points of the text.
+        int mReferenceWidth{};                      ///< The width of the text at the reference size.
+        int mReferenceHeight{};                     ///< The height of the text at the reference size.
+
+    public:
+        ScalableText() = default;
+        explicit ScalableText(std::shared_ptr<Theme>& theme) : TextGadget(theme) {}
+        ScalableText(const ScalableText&) = delete;
+        ScalableText(ScalableText&&) = default;
+        ScalableText& operator = (const ScalableText&) = delete;
+        ScalableText& operator = (ScalableText&&) = default;
+        ~ScalableText() override = default;
+
+        const std::string_view& className() const override { return ScalableText::ClassName; }
+
+        bool initialLayout(Context &context) override;
+
+        void draw(Context &context, Point drawLocation) override;
+
+        /**
+         * @brief Set the scale the text is drawn at.
+         * @details Only redraws the gadget.
+         * @param scale The scale relative to the gadget point size.
+         */
+        [[maybe_unused]] void setScale(float scale) {
+            if (mScale != scale) {
+                mScale = scale;
+                setNeedsDrawing();
+            }
+        }
+
+        /// @return The scale the text is drawn at.
+        [[maybe_unused]] [[nodiscard]] float scale() const { return mScale; }
+
+        /**
+         * @brief Set the point size glyphs are rasterized at.
+         * @param referenceSize The reference point size.
+         */
+        [[maybe_unused]] void setReferenceSize(int referenceSize) {
+            if (mReferenceSize != referenceSize) {
+                mReferenceSize = referenceSize;
+                mReferenceFont.reset();
+                textUpdated();
+            }
+        }
+    };
+
+    /**
+     * @brief Set the text value on a rose::ScalableText
+     * @param gadget Pointer to rose::ScalableText.
+     * @param parameter The param::Text value.
+     */
+    inline void setParameter(std::shared_ptr<ScalableText>& gadget, const param::Text& parameter) {
+        gadget->setText(parameter.data);
+    }
+
+} // rose
+
+#endif //ROSE2_SCALABLETEXT_H
@@ -167,6 +167,15 @@ namespace rose {
          * @return the SDL_Status return code.
          */
         int blitSurface(Surface &source);
+
+        /**
+         * @brief Find the bounding box of the pixels that are not fully transparent.
+         * @details Each row is reduced with a bitwise or of its pixels, which the compiler vectorizes, and
+         * only rows with visible pixels are searched for the left and right edges. Surfaces that are not 32 bits
+         * per pixel are converted first. A Surface without an alpha channel is visible everywhere.
+         * @return The bounding box, an empty Rectangle if every pixel is transparent.
+         */
+        [[nodiscard]] Rectangle alphaBounds() const;
     };
 
     /**
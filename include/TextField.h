@@ -0,0 +1,244 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * TextField.h Created by Richard Buckley (C) 18/10/26
+ */
+
+/**
+ * @file TextField.h
+ * @author Richard Buckley <richard.buckley@ieee.org>
+ * @version 1.0
+ * @date 18/10/26
+ * @brief A single line editable text field.
+ * @details The text is held as code points in a GapBuffer with the gap kept at the caret, alongside a parallel
+ * GapBuffer of glyph advances. The text is drawn as a sequence of runs of a few dozen glyphs, each with its own
+ * Texture. A keystroke edits the buffers at the caret and invalidates only the run the caret is in; the runs
+ * after it keep their Textures and simply move. The field is a fixed size, so editing never requires a layout,
+ * only the part of the field from the edited run onward is exposed. The caret blinks on the animation signal
+ * and exposes only itself.
+ */
+
+#ifndef ROSE2_TEXTFIELD_H
+#define ROSE2_TEXTFIELD_H
+
+#include <TextGadget.h>
+#include <GapBuffer.h>
+
+namespace rose {
+
+    /**
+     * @class TextField
+     * @brief A Gadget for entering a single line of text.
+     * @details The field takes the keyboard focus when clicked. Left, Right, Home and End move the caret,
+     * Backspace and Delete erase, and Return transmits the text on enterSignal.
+     */
+    class TextField : public TextGadget {
+    public:
+        /**
+         * @struct Run
+         * @brief A run of glyphs drawn from one Texture.
+         */
+        struct Run {
+            std::size_t length{};           ///< The number of glyphs in the run.
+            int width{};                    ///< The sum of the glyph advances.
+            SharedTexture texture{};        ///< The rendered run, created when first visible.
+        };
+
+        /**
+         * @struct RunPosition
+         * @brief The location of a run in the text.
+         */
+        struct RunPosition {
+            std::size_t index{};            ///< The index of the run.
+            std::size_t start{};            ///< The position of the first glyph of the run.
+            int offset{};                   ///< The horizontal offset of the run from the start of the text.
+        };
+
+    protected:
+        constexpr static std::string_view ClassName = "TextField";     ///< TextField class name.
+
+        static constexpr std::size_t RunLength = 32;        ///< Glyphs per run when loaded, runs split at twice this.
+        static constexpr uint64_t CaretBlinkPeriod = 500;   ///< Milliseconds the caret is on, or off.
+        static constexpr int CaretWidth = 2;                ///< The width of the caret in pixels.
+
+        GapBuffer<char32_t> mCodes{};       ///< The text code points.
+        GapBuffer<int> mAdvances{};         ///< The advance of each glyph in mCodes.
+        std::vector<Run> mRuns{};           ///< The runs covering mCodes.
+        FontPointer mMeasuredFont{};        ///< The font mAdvances was measured with.
+        bool mLoadRequired{true};           ///< True when mText must be loaded into the buffers.
+
+        std::size_t mCaret{};               ///< The caret position, in glyphs.
+        int mCaretOffset{};                 ///< The horizontal offset of the caret from the start of the text.
+        int mScroll{};                      ///< The horizontal scroll of the text within the field.
+        std::size_t mColumns{20};           ///< The width of the field in digit widths.
+        int mLineHeight{};                  ///< The height of the text.
+
+        bool mCaretOn{};                    ///< True while the blinking caret is shown.
+        uint64_t mCaretTick{};              ///< The time the caret last changed state.
+        AnimationProtocol::slot_type mCaretSlot{};  ///< Connection to the animation signal.
+
+        /**
+         * @brief Find the run containing a glyph position.
+         * @param position The glyph position.
+         * @param atEnd If true a position at the end of a run is taken to be in that run rather than the next.
+         * @return The RunPosition, with index equal to the number of runs if the position is past the end.
+         */
+        [[nodiscard]] RunPosition findRun(std::size_t position, bool atEnd) const;
+
+        /**
+         * @brief Measure the glyph advances and divide the text into runs.
+         */
+        void measureRuns();
+
+        /**
+         * @brief Load mText into the buffers and place the caret at the end.
+         */
+        void loadText();
+
+        /**
+         * @brief Insert code points at the caret and move the caret past them.
+         * @param codes The code points.
+         */
+        void insertCodes(std::u32string_view codes);
+
+        /**
+         * @brief Erase the glyph at a position.
+         * @details The caret moves back if the glyph was before it.
+         * @param position The glyph position.
+         * @return True if a glyph was erased.
+         */
+        bool eraseCode(std::size_t position);
+
+        /**
+         * @brief Load the replaced text into the buffers, the caret is placed at the end of the text.
+         */
+        void textChanged() override {
+            mLoadRequired = true;
+            textUpdated();
+        }
+
+        /**
+         * @brief Compare with the edited text rather than mText, which is not updated by editing.
+         */
+        [[nodiscard]] bool textDiffers(std::string_view text) const override { return this->text() != text; }
+
+        /**
+         * @brief Move the caret.
+         * @param position The new caret position.
+         */
+        void moveCaret(std::size_t position);
+
+        /**
+         * @brief Compute the horizontal offset of the caret from the start of the text.
+         * @return The offset in pixels.
+         */
+        [[nodiscard]] int caretOffset() const;
+
+        /**
+         * @brief Find the glyph boundary nearest a horizontal offset.
+         * @param offset The offset from the start of the text.
+         * @return The glyph position.
+         */
+        [[nodiscard]] std::size_t positionAt(int offset) const;
+
+        /**
+         * @brief Get the UTF8 text of a run.
+         * @param start The position of the first glyph.
+         * @param length The number of glyphs.
+         * @return The text.
+         */
+        [[nodiscard]] std::string runText(std::size_t start, std::size_t length) const;
+
+        /**
+         * @brief Scroll the text so the caret is within the field.
+         * @return True if the scroll changed.
+         */
+        bool scrollToCaret();
+
+        /**
+         * @brief Expose the field from a text offset to the right edge.
+         * @param offset The horizontal offset from the start of the text.
+         */
+        void exposeText(int offset);
+
+        /**
+         * @brief Expose the caret.
+         */
+        void exposeCaret();
+
+        /**
+         * @brief Restart the blink cycle with the caret shown.
+         */
+        void showCaret();
+
+        /**
+         * @brief Receive the animation signal to blink the caret.
+         * @param ticks The current time in milliseconds.
+         */
+        void blinkCaret(uint64_t ticks);
+
+    public:
+        TextField() = default;
+        explicit TextField(std::shared_ptr<Theme>& theme) : TextGadget(theme) {}
+        TextField(const TextField&) = delete;
+        TextField(TextField&&) = default;
+        TextField& operator = (const TextField&) = delete;
+        TextField& operator = (TextField&&) = default;
+        ~TextField() override = default;
+
+        const std::string_view& className() const override { return TextField::ClassName; }
+
+        void initialize() override;
+
+        bool initialLayout(Context &context) override;
+
+        void draw(Context &context, Point drawLocation) override;
+
+        bool mouseButtonEvent(const SDL_MouseButtonEvent &e) override;
+
+        bool keyboardEvent(const SDL_KeyboardEvent &e) override;
+
+        bool textInputEvent(const SDL_TextInputEvent &e) override;
+
+        void keyboardFocusEvent(bool focus) override;
+
+        /**
+         * @brief Signal transmitting the text when Return is pressed.
+         */
+        TextEntryProtocol::signal_type enterSignal{};
+
+        /**
+         * @brief Set the width of the field.
+         * @param columns The width in digit widths.
+         */
+        [[maybe_unused]] void setColumns(std::size_t columns) {
+            if (mColumns != columns) {
+                mColumns = columns;
+                setNeedsLayout();
+                setNeedsDrawing();
+            }
+        }
+
+        /**
+         * @brief Get the text.
+         * @return The UTF8 text.
+         */
+        [[nodiscard]] std::string text() const {
+            return mLoadRequired ? mText : runText(0, mCodes.size());
+        }
+    };
+
+    /**
+     * @brief Set the text value on a rose::TextField
+     * @param gadget Pointer to rose::TextField.
+     * @param parameter The param::Text value.
+     */
+    inline void setParameter(std::shared_ptr<TextField>& gadget, const param::Text& parameter) {
+        gadget->setText(parameter.data);
+    }
+
+} // rose
+
+#endif //ROSE2_TEXTFIELD_H
@@ -26,6 +26,10 @@
 #include <entypo.h>
 #include <exception>
 #include <Material.h>
+#include <TextureCache.h>
+#include <GlyphAtlas.h>
+#include <IconSheet.h>
+#include <CodePointTable.h>
 
 namespace rose {
 
@@ -65,9 +69,12 @@ namespace rose {
         static std::unique_ptr<FontCache> mFontCache;
 
         bool mTextRenderRequired{true};      ///< True when re-rendering of text is required
-        Texture mTexture{};                  ///< The generated Texture.
+        uint64_t mRenderGeneration{};        ///< Incremented for each background render request.
+        SharedTexture mTexture{};            ///< The generated Texture, shared through the TextureCache.
         Size mTextSize{};                    ///< The size of the Texture in pixels.
         std::shared_ptr<_TTF_Font> mFont{};  ///< The cached font used.
+        std::shared_ptr<BitmapFont> mBitmapFont{};  ///< The bitmap font, if mFontName names one.
+        bool mBitmapFontResolved{false};     ///< True when mBitmapFont has been looked up for mFontName.
         std::string mText{};                 ///< The string to render.
 
         /**
@@ -121,6 +128,29 @@ namespace rose {
             throw FontCacheException("TextGadget font cache not initialized.");
         }
 
+        /**
+         * @brief A static method to get a bitmap font through the global text font cache.
+         * @param fontName The name of the font.
+         * @return The font, or nullptr if the name is not a bitmap font or the cache is not initialized.
+         */
+        static std::shared_ptr<BitmapFont> getBitmapFont(std::string_view fontName) {
+            return mFontCache ? mFontCache->getBitmapFont(fontName) : nullptr;
+        }
+
+        /**
+         * @brief Get the bitmap font named by mFontName.
+         * @details When the gadget font is a bitmap font the text is measured and drawn from its glyph strip,
+         * without rendering a Texture. Bitmap fonts have one size, the point size is not used.
+         * @return The bitmap font, or nullptr if the gadget font is not a bitmap font.
+         */
+        BitmapFont *bitmapFont() {
+            if (!mBitmapFontResolved) {
+                mBitmapFont = getBitmapFont(mFontName);
+                mBitmapFontResolved = true;
+            }
+            return mBitmapFont.get();
+        }
+
         /**
          * @brief Get the class name.
          * @return std::string_view &
@@ -133,23 +163,123 @@ namespace rose {
 
         void expose(Context &context, Rectangle exposed) override;
 
+        /**
+         * @brief Get the application TextureCache.
+         * @return A pointer to the TextureCache, or nullptr if the gadget is not attached to an Application.
+         */
+        TextureCache *textureCache();
+
+        /**
+         * @brief Get a bitmap font strip or icon sheet uploaded to the Context renderer.
+         * @details The Texture is held by the application TextureCache. Without an Application it is uploaded
+         * for each draw.
+         * @param context The graphics Context.
+         * @param name The path of the file the sheet was read from.
+         * @param sheet The sheet.
+         * @return The Texture.
+         * @throws SurfaceRuntimeError if the Texture can not be created.
+         */
+        SharedTexture sheetTexture(Context &context, const std::string &name, Surface &sheet);
+
+        /**
+         * @brief Determine if the foreground color is rendered into the Texture.
+         * @details Blended and Solid text is rendered in white and tinted to mTextFgColor when drawn, so a
+         * color change does not require the text to be rendered again. Shaded text has the background color
+         * rendered in with it, so it can not be tinted and the foreground color is rendered into the Texture.
+         * @return True if the foreground color is part of the Texture.
+         */
+        [[nodiscard]] bool isColorBaked() const { return mRenderStyle == RenderStyle::Shaded; }
+
+        /**
+         * @brief Render a string in the gadget font, style and color.
+         * @details The Texture is taken from, or added to, the application TextureCache. Blended and Solid text
+         * is rendered in white to be tinted by draw().
+         * @param context The graphics Context.
+         * @param text The UTF8 text to render, which must not be empty.
+         * @return The rendered Texture.
+         * @throws TextGadgetException
+         */
+        SharedTexture renderText(Context &context, const std::string &text);
+
+        /**
+         * @brief Compute the TextureCache key for text rendered in the gadget font, style and color.
+         * @param context The graphics Context.
+         * @param text The UTF8 text.
+         * @return The key.
+         */
+        [[nodiscard]] TextTextureKey textureKey(Context &context, const std::string &text) const;
+
+        /**
+         * @brief Get the mapping of the gadget font file, used to open the font on a worker thread.
+         * @return The mapping, or nullptr if the font file is not known.
+         */
+        virtual std::shared_ptr<MappedFile> fontFile();
+
+        /**
+         * @brief Request a Texture for text without waiting for it to be rendered.
+         * @details A Texture found in the TextureCache is used at once. Otherwise the text is rasterized on the
+         * Application WorkerPool and uploaded on the UI thread when ready; until then the gadget keeps drawing
+         * its previous Texture, if any, in the space reserved by layout. Without an Application or a known font
+         * file the text is rendered at once by renderText().
+         * @param context The graphics Context.
+         * @param text The UTF8 text to render, which must not be empty.
+         * @throws TextGadgetException
+         */
+        void requestTexture(Context &context, const std::string &text);
+
+        /**
+         * @brief Receive a Surface rasterized by requestTexture().
+         * @details Called on the UI thread. The Surface is uploaded and cached, and used if it answers the most
+         * recent request.
+         * @param key The TextureCache key of the text.
+         * @param surface The rasterized text.
+         * @param generation The value of mRenderGeneration when the request was made.
+         */
+        void textureReady(const TextTextureKey &key, Surface &surface, uint64_t generation);
+
         /**
          * @brief Create a Blended Texture from text.
          * @details Fetches the Font corresponding to mFontName and mPointSize, then renders the text in mText as
-         * UTF8 to mTexture. The foreground color is set to mTextFgColor. If mRenderStyle is set to Shaded the
-         * background color is set to mTextBgColor. The size of the Texture is placed in mTextSize.<p/>
+         * UTF8 to mTexture. The foreground color is white, the Texture is tinted to mTextFgColor by draw(). If
+         * mRenderStyle is set to Shaded the foreground color is set to mTextFgColor and the background color is set
+         * to the gadget background. The size of the Texture is placed in mTextSize. Textures are shared with other
+         * gadgets rendering the same text through the application TextureCache.<p/>
          * If the requested font is not found, or mText is empty any mTexture is reset and mTextSize is set to Zero.
          * @param context The graphics Context.
          * @throws TextGadgetException
          */
         void createTexture(Context &context);
 
+        /**
+         * @brief Measure the text without rendering it.
+         * @details Fetches the Font corresponding to mFontName and mPointSize and places the size of the rendered
+         * text in mTextSize. Text in a bitmap font is measured from the glyph advances. Layout only needs the size,
+         * the Texture is created by draw() the first time the gadget is visible.
+         * @throws TextGadgetException
+         */
+        void measureText();
+
         /**
          * @brief Called when the text is updated.
-         * @details Sets: needs drawing, needs layout, text render required and resets the Texture.
+         * @details Sets: needs drawing, needs layout and text render required. The Texture is kept to be drawn
+         * until its replacement is ready.
          */
         void textUpdated();
 
+        /**
+         * @brief Called by setText() when the text changes.
+         * @details Calls textUpdated(). Derived classes that can redraw less override this.
+         */
+        virtual void textChanged() { textUpdated(); }
+
+        /**
+         * @brief Test if setText() would change the text displayed.
+         * @details Derived classes that keep the text elsewhere once it is edited override this.
+         * @param text The new text.
+         * @return True if the text differs from mText.
+         */
+        [[nodiscard]] virtual bool textDiffers(std::string_view text) const { return mText != text; }
+
         /**
          * @brief Sets the text point size.
          * @details If the size is a change textUpdated() is called.
@@ -158,19 +288,24 @@ namespace rose {
         void setPointSize(int pointSize) {
             if (mPointSize != pointSize) {
                 mPointSize = pointSize;
+                mFont.reset();
                 textUpdated();
             }
         }
 
         /**
          * @brief Sets the text foreground color.
-         * @details If the color changes textUpdated() is called.
+         * @details If the color changes the gadget needs drawing. The Texture is only rendered again, by calling
+         * textUpdated(), if the color is baked into it (see isColorBaked()).
          * @param color the new color.
          */
         void setForeground(Color color) {
             if (mTextFgColor != color) {
                 mTextFgColor = color;
-                textUpdated();
+                if (isColorBaked())
+                    textUpdated();
+                else
+                    setNeedsDrawing();
             }
         }
 
@@ -185,22 +320,25 @@ namespace rose {
         void setFontName(const S &fontName) {
             if (mFontName != fontName) {
                 mFontName = fontName;
+                mFont.reset();
+                mBitmapFont.reset();
+                mBitmapFontResolved = false;
                 textUpdated();
             }
         }
 
         /**
          * @brief Set the text string.
-         * @details If the text changes textUpdated() is called.
+         * @details If the text changes textChanged() is called.
          * @tparam S the type of text.
          * @param text the new text string.
          */
         template<class S>
         requires StringLike<S>
         void setText(const S &text) {
-            if (mText != text) {
+            if (textDiffers(text)) {
                 mText = text;
-                textUpdated();
+                textChanged();
             }
         }
 
@@ -229,6 +367,11 @@ namespace rose {
     /**
      * @class IconGadget
      * @brief Display a Material icon font element.
+     * @details Icons are drawn from a GlyphAtlas shared by every IconGadget using the same font and size, so
+     * changing the icon, as buttons do on each change of state, only changes the atlas rectangle drawn. Icons
+     * on the build time IconSheet, if one is loaded for the gadget point size, are drawn from it without using
+     * the icon font at all. When MINIMIZE_ENTYPO is defined icons are trimmed to their visible pixels and each
+     * has its own Texture.
      */
     class IconGadget : public TextGadget {
     protected:
@@ -238,8 +381,24 @@ namespace rose {
          */
         static std::unique_ptr<Material> mMaterial;
 
+        /**
+         * @brief Global pointer to the icon sheet generated at build time, if any.
+         */
+        static std::unique_ptr<IconSheet> mIconSheet;
+
+        /**
+         * @brief The trimmed size of icons by trimKey(), so layout does not have to render an icon to size it.
+         */
+        static std::unordered_map<uint64_t, Size> mTrimSizes;
+
+        /// @return The mTrimSizes key of the icon code point and point size.
+        [[nodiscard]] uint64_t trimKey() const {
+            return static_cast<uint64_t>(static_cast<uint32_t>(mPointSize)) << 32u | mIconCode;
+        }
+
         constexpr static std::string_view ClassName = "IconGadget";     ///< Class name.
         uint32_t mIconCode{};                                           ///< The codepoint.
+        std::shared_ptr<GlyphAtlas> mAtlas{};                           ///< The shared icon atlas.
 
     public:
         /**
@@ -255,6 +414,21 @@ namespace rose {
             mMaterial = std::make_unique<Material>(fontSearchPaths, fontName);
         }
 
+        /**
+         * @brief Static method to load the icon sheet generated at build time by IconSheetGen.
+         * @details If the sheet can not be loaded icons are rendered from the Material font.
+         * @param basePath The path of the sheet files without extension.
+         */
+        static void InitializeIconSheet(const std::filesystem::path &basePath);
+
+        /**
+         * @brief Find an icon on the icon sheet.
+         * @param code The icon code point.
+         * @return The sheet Entry, or nullptr if there is no sheet for the gadget point size or it does not hold
+         * the icon.
+         */
+        [[nodiscard]] const IconSheet::Entry *sheetEntry(uint32_t code) const;
+
         IconGadget() = default;
         explicit IconGadget(std::shared_ptr<Theme>& theme);
         IconGadget(const IconGadget&) = delete;
@@ -272,30 +446,40 @@ namespace rose {
         void draw(Context &context, Point drawLocation) override;
 
         /**
-         * @brief Create a Blended Texture from text.
-         * @details Fetches the Font corresponding to mFontName and mPointSize, then renders the text in mText as
-         * UTF8 to mTexture. The foreground color is set to mTextFgColor. If mRenderStyle is set to Shaded the
-         * background color is set to mTextBgColor. The size of the Texture is placed in mTextSize.<p/>
-         * If the requested font is not found, or mText is empty any mTexture is reset and mTextSize is set to Zero.
+         * @brief Create a Blended Texture from the icon code point.
+         * @details Fetches the Material font at mPointSize, then renders the code point in mIconCode to mTexture
+         * in white. The Texture is tinted to mTextFgColor by draw(). The size of the Texture is placed in mTextSize.
+         * Textures are shared through the application TextureCache. When MINIMIZE_ENTYPO is defined the glyph is
+         * trimmed to Surface::alphaBounds() and the trimmed size is cached by code point and point size.
          * @param context The graphics Context.
          * @throws TextGadgetException
          */
         void createIconTexture(Context &context);
 
+        /**
+         * @brief Get the mapping of the Material icon font file.
+         * @return The mapping, or nullptr if the font file is not known.
+         */
+        std::shared_ptr<MappedFile> fontFile() override;
+
+        /**
+         * @brief Measure the icon glyph without rendering it.
+         * @details The size of the rendered glyph, or of the icon on the icon sheet, is placed in mTextSize.
+         * @throws TextGadgetException
+         */
+        void measureIcon();
+
         /**
          * @brief Set the icon codepoint.
-         * @details If the codepoint changes textUpdated() is called.
+         * @details If the codepoint changes and the new icon has the same advance as the old one, the gadget only
+         * needs drawing. Otherwise textUpdated() is called.
          * @param icon the codepoint.
          */
-        void setIcon(uint32_t icon) {
-            if (mIconCode != icon) {
-                mIconCode = icon;
-                textUpdated();
-            }
-        }
+        void setIcon(uint32_t icon);
 
         /**
          * @brief Convert a code point name into a code point.
+         * @details The compiled code point table is searched first, then the codepoints file loaded by Material.
          * @tparam String The type of the code point name.
          * @param codePointName The code point name.
          * @return the code point.
@@ -303,12 +487,30 @@ namespace rose {
         template<class String>
                 requires StringLike<String>
         static uint32_t getIcon(const String& codePointName) {
-            if (auto itr = mMaterial->find(std::string{codePointName}); itr != mMaterial->end()) {
-                return itr->second;
-            }
+            if (auto code = findIcon(codePointName); code)
+                return code.value();
             throw CodePointError(fmt::format("Code point error: code point '{}' not found.", codePointName));
         }
 
+        /**
+         * @brief Find the code point of a code point name.
+         * @tparam String The type of the code point name.
+         * @param codePointName The code point name.
+         * @return The code point, or std::nullopt if the name is not known.
+         */
+        template<class String>
+                requires StringLike<String>
+        static std::optional<uint32_t> findIcon(const String& codePointName) {
+            std::string_view name{codePointName};
+            if (auto code = materialCodePoint(name); code)
+                return code;
+            if (mMaterial) {
+                if (auto itr = mMaterial->find(std::string{name}); itr != mMaterial->end())
+                    return itr->second;
+            }
+            return std::nullopt;
+        }
+
         /**
          * @brief Set the icon codepoint from a code point name.
          * @details The code point names are read in from the codepoints file that comes along with the font file.
@@ -319,8 +521,8 @@ namespace rose {
         template<class String>
                 requires StringLike<String>
         void setIcon(String codePointName) {
-            if (auto itr = mMaterial->find(codePointName); itr != mMaterial->end()) {
-                setIcon(itr->second);
+            if (auto code = findIcon(codePointName); code) {
+                setIcon(code.value());
             }
         }
 
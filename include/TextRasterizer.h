@@ -0,0 +1,53 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * TextRasterizer.h Created by Richard Buckley (C) 18/10/26
+ */
+
+/**
+ * @file TextRasterizer.h
+ * @author Richard Buckley <richard.buckley@ieee.org>
+ * @version 1.0
+ * @date 18/10/26
+ * @brief Rasterize text to a Surface on a worker thread.
+ * @details A TTF_Font may not be used by two threads at once, so each worker thread opens its own fonts from
+ * the font file mappings shared with the FontManager. Only the Surface is produced off the UI thread, the
+ * Texture is created from it on the UI thread.
+ */
+
+#ifndef ROSE2_TEXTRASTERIZER_H
+#define ROSE2_TEXTRASTERIZER_H
+
+#include <Font.h>
+#include <Color.h>
+#include <Surface.h>
+#include <RoseTypes.h>
+#include <string>
+
+namespace rose {
+
+    /**
+     * @struct TextRasterRequest
+     * @brief Everything needed to rasterize text away from the Gadget that requested it.
+     */
+    struct TextRasterRequest {
+        std::shared_ptr<MappedFile> fontFile{};     ///< The font file mapping.
+        int pointSize{};                            ///< The font point size.
+        RenderStyle renderStyle{};                  ///< The render style.
+        Color foreground{};                         ///< The foreground color.
+        Color background{};                         ///< The background color, used by Shaded text.
+        std::string text{};                         ///< The UTF8 text.
+    };
+
+    /**
+     * @brief Rasterize text using a font opened for the calling thread.
+     * @param request The request.
+     * @return The Surface, empty on failure.
+     */
+    Surface rasterizeText(const TextRasterRequest &request);
+
+} // rose
+
+#endif //ROSE2_TEXTRASTERIZER_H
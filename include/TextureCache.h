@@ -0,0 +1,199 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * TextureCache.h Created by Richard Buckley (C) 18/10/26
+ */
+
+/**
+ * @file TextureCache.h
+ * @author Richard Buckley <richard.buckley@ieee.org>
+ * @version 1.0
+ * @date 18/10/26
+ * @brief An application level cache of rendered textures.
+ * @details Gadgets that render the same string in the same font, size, style and color share one Texture. The
+ * cache holds textures in a least recently used order and evicts textures no Gadget is using when the byte budget
+ * is exceeded. Textures belong to the renderer that created them, so the renderer is part of every key.
+ */
+
+#ifndef ROSE2_TEXTURECACHE_H
+#define ROSE2_TEXTURECACHE_H
+
+#include <Rose.h>
+#include <GraphicsModel.h>
+#include <LruCache.h>
+#include <GlyphAtlas.h>
+#include <Surface.h>
+#include <string>
+#include <unordered_map>
+
+namespace rose {
+
+    using SharedTexture = std::shared_ptr<Texture>;     ///< A Texture shared through a cache.
+
+    /**
+     * @struct TextTextureKey
+     * @brief The attributes which identify a rendered text Texture.
+     */
+    struct TextTextureKey {
+        SDL_Renderer *renderer{};           ///< The renderer that owns the Texture.
+        std::string fontName{};             ///< The font name.
+        int pointSize{};                    ///< The font point size.
+        RenderStyle renderStyle{};          ///< The render style.
+        uint32_t foreground{};              ///< The packed RGBA foreground color rendered into the Texture.
+        uint32_t background{};              ///< The packed RGBA background color, used by Shaded text.
+        std::string text{};                 ///< The rendered text.
+
+        bool operator==(const TextTextureKey &other) const = default;
+
+        /**
+         * @brief Pack a Color for use in a key.
+         * @param color The Color.
+         * @return The packed RGBA value.
+         */
+        static uint32_t pack(const Color &color) {
+            auto c = color.sdlColor();
+            return static_cast<uint32_t>(c.r) << 24u | static_cast<uint32_t>(c.g) << 16u |
+                   static_cast<uint32_t>(c.b) << 8u | static_cast<uint32_t>(c.a);
+        }
+    };
+
+    /**
+     * @struct TextTextureKeyHash
+     * @brief Hash functor for TextTextureKey.
+     */
+    struct TextTextureKeyHash {
+        std::size_t operator()(const TextTextureKey &key) const noexcept;
+    };
+
+    /**
+     * @struct GlyphAtlasKey
+     * @brief The attributes which identify a GlyphAtlas.
+     */
+    struct GlyphAtlasKey {
+        SDL_Renderer *renderer{};           ///< The renderer that owns the atlas pages.
+        std::string fontName{};             ///< The font name.
+        int pointSize{};                    ///< The font point size.
+
+        bool operator==(const GlyphAtlasKey &other) const = default;
+    };
+
+    /**
+     * @struct GlyphAtlasKeyHash
+     * @brief Hash functor for GlyphAtlasKey.
+     */
+    struct GlyphAtlasKeyHash {
+        std::size_t operator()(const GlyphAtlasKey &key) const noexcept;
+    };
+
+    /**
+     * @struct SheetTextureKey
+     * @brief The attributes which identify an uploaded glyph strip or icon sheet.
+     */
+    struct SheetTextureKey {
+        SDL_Renderer *renderer{};           ///< The renderer that owns the Texture.
+        std::string name{};                 ///< The path of the file the sheet was read from.
+
+        bool operator==(const SheetTextureKey &other) const = default;
+    };
+
+    /**
+     * @struct SheetTextureKeyHash
+     * @brief Hash functor for SheetTextureKey.
+     */
+    struct SheetTextureKeyHash {
+        std::size_t operator()(const SheetTextureKey &key) const noexcept;
+    };
+
+    /**
+     * @class TextureCache
+     * @brief The application level cache of rendered text textures and glyph atlases.
+     */
+    class TextureCache {
+    public:
+        static constexpr std::size_t DefaultTextBudget = 16 * 1024 * 1024;    ///< Default text budget in bytes.
+        static constexpr std::size_t DefaultAtlasLimit = 32;    ///< Default number of glyph atlases kept.
+
+    protected:
+        LruCache<TextTextureKey, Texture, TextTextureKeyHash> mTextCache{DefaultTextBudget};  ///< Text textures.
+
+        /// Glyph atlases, one per renderer, font and size. Each costs one, atlases held by a Gadget are kept.
+        LruCache<GlyphAtlasKey, GlyphAtlas, GlyphAtlasKeyHash> mGlyphAtlases{DefaultAtlasLimit};
+
+        /// Bitmap font strips and icon sheets uploaded to each renderer.
+        std::unordered_map<SheetTextureKey, SharedTexture, SheetTextureKeyHash> mSheets{};
+
+    public:
+        TextureCache() = default;
+        TextureCache(const TextureCache&) = delete;
+        TextureCache(TextureCache&&) = default;
+        TextureCache& operator=(const TextureCache&) = delete;
+        TextureCache& operator=(TextureCache&&) = default;
+        ~TextureCache() = default;
+
+        /**
+         * @brief Find a text Texture.
+         * @param key The text attributes.
+         * @return The Texture, or an empty pointer if it is not cached.
+         */
+        SharedTexture findText(const TextTextureKey &key) { return mTextCache.find(key); }
+
+        /**
+         * @brief Add a text Texture to the cache.
+         * @details The byte cost of the Texture is computed from its size assuming four bytes per pixel.
+         * @param key The text attributes.
+         * @param texture The Texture.
+         * @return The shared Texture.
+         */
+        SharedTexture insertText(const TextTextureKey &key, Texture &&texture);
+
+        /**
+         * @brief Get the GlyphAtlas for a font and size, creating it if required.
+         * @details Atlases no Gadget holds are evicted, least recently used first, beyond the atlas limit.
+         * @param context The graphics Context the atlas is drawn with.
+         * @param fontName The font name.
+         * @param pointSize The font point size.
+         * @param font The font, used if the atlas is created.
+         * @return The shared GlyphAtlas.
+         */
+        std::shared_ptr<GlyphAtlas> glyphAtlas(Context &context, const std::string &fontName, int pointSize,
+                                               const FontPointer &font);
+
+        /**
+         * @brief Get a sheet Surface uploaded to a renderer, uploading it if required.
+         * @details Sheets are held by static caches which outlive every renderer, only the Surface is kept there.
+         * @param context The graphics Context the sheet is drawn with.
+         * @param name The path of the file the sheet was read from.
+         * @param sheet The sheet, used if the Texture is created.
+         * @return The shared Texture, with blending enabled.
+         * @throws SurfaceRuntimeError if the Texture can not be created.
+         */
+        SharedTexture sheetTexture(Context &context, const std::string &name, Surface &sheet);
+
+        /**
+         * @brief Remove all textures owned by a renderer.
+         * @details Called by the Window destructor, before the renderer is destroyed.
+         * @param renderer The renderer.
+         */
+        void purgeRenderer(SDL_Renderer *renderer);
+
+        /**
+         * @brief Set the byte budget of the text textures.
+         * @param budget The budget in bytes.
+         */
+        [[maybe_unused]] void setTextBudget(std::size_t budget) { mTextCache.setBudget(budget); }
+
+        /**
+         * @brief Set the number of glyph atlases kept when no Gadget holds them.
+         * @param limit The number of atlases.
+         */
+        [[maybe_unused]] void setAtlasLimit(std::size_t limit) { mGlyphAtlases.setBudget(limit); }
+
+        /// @return The number of bytes of text textures held by the cache.
+        [[maybe_unused]] [[nodiscard]] std::size_t textCost() const { return mTextCache.cost(); }
+    };
+
+} // rose
+
+#endif //ROSE2_TEXTURECACHE_H
@@ -0,0 +1,167 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * TilePyramid.h Created by Richard Buckley (C) 18/10/26
+ */
+
+/**
+ * @file TilePyramid.h
+ * @author Richard Buckley <richard.buckley@ieee.org>
+ * @version 1.0
+ * @date 18/10/26
+ * @brief An image cut into fixed size tiles at a series of halving resolutions.
+ * @details The pyramid of an image file is built once and stored as PNG tiles in the XDG cache, in a directory
+ * named by fileCacheKey() so an edited image is built again. The pyramids of one image file share a parent
+ * directory named from its path, and building a pyramid removes the others there. Building decodes the whole
+ * image; after that any part of it at any level can be loaded a tile at a time, so the memory used to display an
+ * image is bounded by the number of tiles kept, not by the size of the image.
+ */
+
+#ifndef ROSE2_TILEPYRAMID_H
+#define ROSE2_TILEPYRAMID_H
+
+#include <Rose.h>
+#include <Surface.h>
+#include <filesystem>
+#include <stdexcept>
+#include <string_view>
+
+namespace rose {
+
+    /**
+     * @class TilePyramidError
+     * @brief Thrown when a tile pyramid can not be built.
+     */
+    class TilePyramidError : public std::runtime_error {
+    public:
+        explicit TilePyramidError(const std::string &what_arg) : std::runtime_error(what_arg) {}
+    };
+
+    /**
+     * @struct TileKey
+     * @brief The position of a tile in a TilePyramid.
+     */
+    struct TileKey {
+        int level{};        ///< The level, zero is the full resolution.
+        int column{};       ///< The column of the tile in the level.
+        int row{};          ///< The row of the tile in the level.
+
+        bool operator==(const TileKey &other) const = default;
+    };
+
+    /**
+     * @struct TileKeyHash
+     * @brief Hash functor for TileKey.
+     */
+    struct TileKeyHash {
+        std::size_t operator()(const TileKey &key) const noexcept {
+            return std::hash<uint64_t>{}(static_cast<uint64_t>(key.level) << 56u ^
+                                         static_cast<uint64_t>(key.column) << 28u ^ static_cast<uint64_t>(key.row));
+        }
+    };
+
+    /**
+     * @class TilePyramid
+     * @brief The tiles of an image file.
+     * @details Each level is the previous one halved with halveImage(), the last level fits in a single tile.
+     * load() and build() may be called on any thread, the other methods only once one of them has succeeded.
+     */
+    class TilePyramid {
+    public:
+        static constexpr int TileSize = 256;                                    ///< Width and height of a tile.
+        static constexpr std::string_view ManifestName = "pyramid";             ///< Written when a build completes.
+        static constexpr std::string_view ManifestVersion = "rose-tile-pyramid 1";  ///< First line of the manifest.
+
+    protected:
+        std::filesystem::path mSource{};        ///< The image file.
+        std::filesystem::path mCacheRoot{};     ///< The directory pyramids are stored in.
+        std::filesystem::path mSourceDirectory{};   ///< The directory of all pyramids of the image file.
+        std::filesystem::path mDirectory{};     ///< The directory of this pyramid.
+        Size mSize{};                           ///< The size of the image.
+        int mLevels{};                          ///< The number of levels, zero until loaded or built.
+
+        /**
+         * @brief Set mDirectory from the source file.
+         * @return false if the source file does not exist.
+         */
+        bool locate();
+
+        /**
+         * @brief Remove the pyramids of earlier versions of the image file.
+         */
+        void pruneVersions();
+
+    public:
+        TilePyramid() = delete;
+        TilePyramid(const TilePyramid &) = delete;
+        TilePyramid(TilePyramid &&) = default;
+        TilePyramid &operator=(const TilePyramid &) = delete;
+        TilePyramid &operator=(TilePyramid &&) = default;
+        ~TilePyramid() = default;
+
+        /**
+         * @brief Constructor.
+         * @param source The image file.
+         * @param cacheRoot The directory to store pyramids in, empty for the Rose "tiles" cache directory.
+         */
+        explicit TilePyramid(std::filesystem::path source, std::filesystem::path cacheRoot = {})
+                : mSource(std::move(source)), mCacheRoot(std::move(cacheRoot)) {}
+
+        /**
+         * @brief Load the pyramid of the current version of the source file if it has been built.
+         * @return true if the pyramid is ready.
+         */
+        bool load();
+
+        /**
+         * @brief Build the pyramid of the source file.
+         * @details The manifest is written last, so an interrupted build is not loaded. The pyramids of earlier
+         * versions of the image file are removed once the build completes.
+         * @throws TilePyramidError if the image can not be decoded or a tile can not be written.
+         */
+        void build();
+
+        /// @return true once the pyramid has been loaded or built.
+        [[nodiscard]] bool ready() const { return mLevels > 0; }
+
+        /// @return The size of the image.
+        [[nodiscard]] Size size() const { return mSize; }
+
+        /// @return The number of levels.
+        [[nodiscard]] int levels() const { return mLevels; }
+
+        /**
+         * @brief Compute the size of a level.
+         * @param level The level.
+         * @return The size.
+         */
+        [[nodiscard]] Size levelSize(int level) const;
+
+        /**
+         * @brief Compute the number of tile columns and rows in a level.
+         * @param level The level.
+         * @return The columns as the width and rows as the height.
+         */
+        [[nodiscard]] Size tileGrid(int level) const;
+
+        /**
+         * @brief The area of a level covered by a tile.
+         * @param key The tile.
+         * @return The Rectangle in level pixels, tiles on the right and bottom edges may be smaller than TileSize.
+         */
+        [[nodiscard]] Rectangle tileRectangle(const TileKey &key) const;
+
+        /**
+         * @brief Load a tile.
+         * @details May be called on any thread.
+         * @param key The tile.
+         * @return The tile, empty if it can not be read.
+         */
+        [[nodiscard]] Surface loadTile(const TileKey &key) const;
+    };
+
+} // rose
+
+#endif //ROSE2_TILEPYRAMID_H
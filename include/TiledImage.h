@@ -0,0 +1,172 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * TiledImage.h Created by Richard Buckley (C) 18/10/26
+ */
+
+/**
+ * @file TiledImage.h
+ * @author Richard Buckley <richard.buckley@ieee.org>
+ * @version 1.0
+ * @date 18/10/26
+ * @brief A Gadget that pans and zooms an image too large to upload whole.
+ * @details The image is shown from a TilePyramid. Only the tiles of the level that matches the zoom and cover the
+ * view are loaded, on the Application WorkerPool, and the uploaded tiles are kept in a least recently used cache
+ * with a byte budget. While a tile loads the covering part of a coarser tile already loaded is drawn in its place.
+ * The view is dragged with the left mouse button or one finger and zoomed with the mouse wheel or two fingers.
+ */
+
+#ifndef ROSE2_TILEDIMAGE_H
+#define ROSE2_TILEDIMAGE_H
+
+#include <filesystem>
+#include <unordered_map>
+#include <unordered_set>
+#include "Gadget.h"
+#include "LruCache.h"
+#include "TilePyramid.h"
+
+namespace rose {
+
+/**
+ * @class TiledImage
+ * @brief Display a very large image file with pan and zoom.
+ */
+    class TiledImage : public Gadget {
+    public:
+        static constexpr std::size_t DefaultTileBudget = 64 * 1024 * 1024;     ///< Default tile budget in bytes.
+        static constexpr std::size_t MaxTileLoads = 8;      ///< Tile loads submitted to the WorkerPool at once.
+        static constexpr double MaxScale = 4.0;             ///< Greatest zoom, in screen pixels per image pixel.
+        static constexpr double WheelZoomStep = 1.25;       ///< Zoom factor of one mouse wheel step.
+        static constexpr Size DefaultViewSize{640, 480};    ///< Largest size used when none is set.
+
+    protected:
+        std::filesystem::path mImageFilePath{};
+        std::shared_ptr<TilePyramid> mPyramid{};        ///< The pyramid, set once it is ready.
+        bool mPyramidRequested{false};                  ///< True when the pyramid has been submitted for building.
+        uint64_t mGeneration{};                         ///< Incremented when the file changes, stale results are dropped.
+
+        LruCache<TileKey, Texture, TileKeyHash> mTiles{DefaultTileBudget};     ///< Uploaded tiles.
+        std::unordered_set<TileKey, TileKeyHash> mLoading{};   ///< Tiles being loaded.
+        std::unordered_set<TileKey, TileKeyHash> mFailed{};    ///< Tiles that could not be loaded.
+
+        double mScale{};                    ///< Screen pixels per image pixel, zero until the image is fitted.
+        double mViewX{};                    ///< Image x co-ordinate at the left of the view.
+        double mViewY{};                    ///< Image y co-ordinate at the top of the view.
+        Size mViewSize{};                   ///< The size of the view when last drawn.
+        Color mPlaceholderColor{};          ///< The color drawn where no tile is loaded.
+        bool mDragging{false};              ///< True while the left mouse button drags the view.
+
+        /// Touch positions in pixels by finger.
+        std::unordered_map<SDL_FingerID, std::pair<double,double>> mFingers{};
+
+        /**
+         * @brief Submit the pyramid for loading, or building, on the WorkerPool.
+         */
+        void requestPyramid();
+
+        /**
+         * @brief Receive the pyramid on the UI thread.
+         * @param pyramid The pyramid.
+         * @param error Empty, or why the pyramid could not be built.
+         * @param generation The value of mGeneration when the request was made.
+         */
+        void pyramidReady(const std::shared_ptr<TilePyramid> &pyramid, const std::string &error, uint64_t generation);
+
+        /**
+         * @brief Submit a tile for loading on the WorkerPool.
+         * @details Nothing is done if the tile is already loading or MaxTileLoads are in progress; the tile is
+         * requested again when it is next drawn.
+         * @param key The tile.
+         */
+        void requestTile(const TileKey &key);
+
+        /**
+         * @brief Receive a loaded tile on the UI thread.
+         * @param key The tile.
+         * @param surface The tile, empty if it could not be read.
+         * @param generation The value of mGeneration when the request was made.
+         */
+        void tileReady(const TileKey &key, Surface &surface, uint64_t generation);
+
+        /**
+         * @brief Draw a tile, or the part of a coarser tile covering it if it is not loaded.
+         * @param context The graphics Context.
+         * @param view The view on the screen.
+         * @param key The tile.
+         */
+        void drawTile(Context &context, const Rectangle &view, const TileKey &key);
+
+        /// @return The scale that fits the whole image in the view.
+        [[nodiscard]] double fitScale() const;
+
+        /// @return The level with the fewest pixels that is not enlarged at the current scale.
+        [[nodiscard]] int levelForScale() const;
+
+        /**
+         * @brief Keep the image in the view, centering it where it is smaller than the view.
+         */
+        void clampView();
+
+        /**
+         * @brief Move the view.
+         * @param dx Screen pixels to move the image right.
+         * @param dy Screen pixels to move the image down.
+         */
+        void pan(double dx, double dy);
+
+        /**
+         * @brief Zoom keeping one point of the image under the same point of the view.
+         * @param x The view x co-ordinate of the fixed point.
+         * @param y The view y co-ordinate of the fixed point.
+         * @param factor The change in scale.
+         */
+        void zoomAbout(double x, double y, double factor);
+
+    public:
+        TiledImage() = default;
+        explicit TiledImage(const std::shared_ptr<Theme>& theme) : Gadget(theme) {
+            mPlaceholderColor = theme->colorShades[ThemeColor::Bottom];
+        }
+        TiledImage(const TiledImage &) = delete;
+        TiledImage(TiledImage &&) = default;
+        TiledImage &operator=(const TiledImage &) = delete;
+        TiledImage &operator=(TiledImage &&) = default;
+        ~TiledImage() override = default;
+
+        /**
+         * @brief Set the image file.
+         * @details The previous image is discarded, the pyramid of the new file is loaded or built when the
+         * gadget is next drawn and the whole image is fitted to the view.
+         * @param path The image file path.
+         */
+        void setFilePath(const std::filesystem::path &path);
+
+        /**
+         * @brief Set the byte budget of uploaded tiles.
+         * @param budget The budget in bytes.
+         */
+        [[maybe_unused]] void setTileBudget(std::size_t budget) { mTiles.setBudget(budget); }
+
+        bool initialLayout(Context &context) override;
+
+        void draw(Context &context, Point drawLocation) override;
+
+        bool mouseButtonEvent(const SDL_MouseButtonEvent &e) override;
+
+        bool mouseMotionEvent(const SDL_MouseMotionEvent &e) override;
+
+        bool mouseWheelEvent(const SDL_MouseWheelEvent &e) override;
+
+        bool fingerTouchEvent(const SDL_TouchFingerEvent &e) override;
+    };
+
+    inline void setParameter(std::shared_ptr<TiledImage>& gadget, const std::filesystem::path& path) {
+        gadget->setFilePath(path);
+    }
+
+} // rose
+
+#endif //ROSE2_TILEDIMAGE_H
@@ -0,0 +1,250 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * VideoFrame.h Created by Richard Buckley (C) 18/10/26
+ */
+
+/**
+ * @file VideoFrame.h
+ * @author Richard Buckley <richard.buckley@ieee.org>
+ * @version 1.0
+ * @date 18/10/26
+ * @brief A Gadget that shows YUV video frames from a producer thread.
+ * @details A producer, a camera or SDR thread, fills a YuvFrame and posts it to a FrameMailbox. The mailbox holds
+ * one frame; posting a frame replaces one the UI has not taken, so a slow display drops stale frames instead of
+ * falling behind. Once per display frame the VideoFrame gadget takes the latest frame and uploads its planes
+ * straight from the producer's buffer to an IYUV or NV12 streaming Texture, the renderer converts to RGB. Taken
+ * frames are handed back through a recycle slot so the producer does not allocate a buffer per frame. The
+ * mailbox uses only atomic exchanges, neither side ever waits for the other.
+ */
+
+#ifndef ROSE2_VIDEOFRAME_H
+#define ROSE2_VIDEOFRAME_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "Gadget.h"
+
+namespace rose {
+
+    namespace param {
+        struct VideoSize { Size data; };
+    }
+
+    /**
+     * @class VideoFrameError
+     * @brief Thrown for a frame format that is not supported.
+     */
+    class VideoFrameError : public std::runtime_error {
+    public:
+        explicit VideoFrameError(const std::string &what_arg) : std::runtime_error(what_arg) {}
+    };
+
+    /**
+     * @struct YuvFrame
+     * @brief A planar IYUV or semi-planar NV12 frame in one buffer.
+     * @details The chroma planes are subsampled 2:1 both ways, odd sizes round up. IYUV has Y, U and V planes,
+     * NV12 has a Y plane and an interleaved UV plane.
+     */
+    struct YuvFrame {
+        SDL_PixelFormatEnum format{SDL_PIXELFORMAT_IYUV};  ///< SDL_PIXELFORMAT_IYUV or SDL_PIXELFORMAT_NV12.
+        Size size{};                        ///< Frame size in pixels.
+        std::vector<uint8_t> data{};        ///< All planes.
+        std::array<std::size_t, 3> offset{};    ///< Offset of each plane in data.
+        std::array<int, 3> pitch{};         ///< Bytes per row of each plane, zero for planes the format lacks.
+
+        YuvFrame() = default;
+
+        /**
+         * @brief Constructor.
+         * @param frameFormat SDL_PIXELFORMAT_IYUV or SDL_PIXELFORMAT_NV12.
+         * @param frameSize The frame size.
+         * @throws VideoFrameError for other formats.
+         */
+        YuvFrame(SDL_PixelFormatEnum frameFormat, Size frameSize);
+
+        /// @return The number of planes, 3 for IYUV and 2 for NV12.
+        [[nodiscard]] int planes() const { return format == SDL_PIXELFORMAT_NV12 ? 2 : 3; }
+
+        /// @return The rows in a plane.
+        [[nodiscard]] int rows(int plane) const { return plane == 0 ? size.h : (size.h + 1) / 2; }
+
+        /// @return The first byte of a plane.
+        uint8_t *plane(int plane) { return data.data() + offset[static_cast<std::size_t>(plane)]; }
+
+        /// @return The first byte of a plane.
+        [[nodiscard]] const uint8_t *plane(int plane) const {
+            return data.data() + offset[static_cast<std::size_t>(plane)];
+        }
+    };
+
+    /**
+     * @class FrameMailbox
+     * @brief A lock free single slot hand off of YuvFrames from one producer to the UI thread.
+     */
+    class FrameMailbox {
+    protected:
+        std::atomic<YuvFrame *> mLatest{nullptr};   ///< The newest posted frame not yet taken.
+        std::atomic<YuvFrame *> mRecycle{nullptr};  ///< A frame buffer for the producer to reuse.
+        std::atomic<uint64_t> mDropped{};           ///< Frames replaced before they were taken.
+
+        /**
+         * @brief Offer a frame buffer for reuse, freeing it if the recycle slot is full.
+         */
+        void putRecycle(std::unique_ptr<YuvFrame> frame);
+
+    public:
+        FrameMailbox() = default;
+        FrameMailbox(const FrameMailbox &) = delete;
+        FrameMailbox(FrameMailbox &&) = delete;
+        FrameMailbox &operator=(const FrameMailbox &) = delete;
+        FrameMailbox &operator=(FrameMailbox &&) = delete;
+        ~FrameMailbox();
+
+        /**
+         * @brief Get a frame to fill, for the producer.
+         * @details A recycled buffer is returned when it has the requested format and size.
+         * @param format SDL_PIXELFORMAT_IYUV or SDL_PIXELFORMAT_NV12.
+         * @param size The frame size.
+         * @return The frame.
+         */
+        std::unique_ptr<YuvFrame> acquire(SDL_PixelFormatEnum format, Size size);
+
+        /**
+         * @brief Post a filled frame, for the producer.
+         * @details A frame posted earlier and not yet taken is dropped.
+         * @param frame The frame.
+         */
+        void post(std::unique_ptr<YuvFrame> frame);
+
+        /**
+         * @brief Take the newest frame, for the UI thread.
+         * @return The frame, or empty if none has been posted since the last take.
+         */
+        std::unique_ptr<YuvFrame> take();
+
+        /**
+         * @brief Return a taken frame once it has been uploaded, for the UI thread.
+         * @param frame The frame.
+         */
+        void recycle(std::unique_ptr<YuvFrame> frame) { putRecycle(std::move(frame)); }
+
+        /// @return The number of frames dropped because a newer one was posted before they were taken.
+        [[nodiscard]] uint64_t dropped() const { return mDropped.load(std::memory_order_relaxed); }
+    };
+
+    /**
+     * @class SyntheticFrameSource
+     * @brief A producer thread posting a moving test pattern, for testing without a camera.
+     */
+    class SyntheticFrameSource {
+    protected:
+        std::shared_ptr<FrameMailbox> mMailbox;     ///< Where frames are posted.
+        SDL_PixelFormatEnum mFormat;                ///< The frame format.
+        Size mSize;                                 ///< The frame size.
+        uint32_t mInterval;                         ///< Milliseconds between frames.
+        std::atomic<bool> mRunning{false};          ///< Cleared to stop the thread.
+        std::thread mThread{};                      ///< The producer thread.
+
+        /**
+         * @brief The producer thread.
+         */
+        void run();
+
+    public:
+        SyntheticFrameSource() = delete;
+        SyntheticFrameSource(const SyntheticFrameSource &) = delete;
+        SyntheticFrameSource(SyntheticFrameSource &&) = delete;
+        SyntheticFrameSource &operator=(const SyntheticFrameSource &) = delete;
+        SyntheticFrameSource &operator=(SyntheticFrameSource &&) = delete;
+
+        /**
+         * @brief Constructor. Starts the producer thread.
+         * @param mailbox Where frames are posted.
+         * @param format SDL_PIXELFORMAT_IYUV or SDL_PIXELFORMAT_NV12.
+         * @param size The frame size.
+         * @param framesPerSecond The frame rate.
+         */
+        SyntheticFrameSource(std::shared_ptr<FrameMailbox> mailbox, SDL_PixelFormatEnum format, Size size,
+                             uint32_t framesPerSecond = 30);
+
+        /**
+         * @brief Destructor. Stops the producer thread.
+         */
+        ~SyntheticFrameSource();
+
+        /**
+         * @brief Draw the test pattern into a frame.
+         * @param frame The frame.
+         * @param sequence The frame number, which moves the pattern.
+         */
+        static void fillPattern(YuvFrame &frame, uint64_t sequence);
+    };
+
+/**
+ * @class VideoFrame
+ * @brief Display the latest frame posted to a FrameMailbox.
+ */
+    class VideoFrame : public Gadget {
+    protected:
+        std::shared_ptr<FrameMailbox> mMailbox{std::make_shared<FrameMailbox>()};  ///< Frames from the producer.
+        Texture mTexture{};                 ///< The streaming texture the latest frame is uploaded to.
+        SDL_PixelFormatEnum mTextureFormat{SDL_PIXELFORMAT_UNKNOWN};   ///< The format of mTexture.
+        Size mFrameSize{};                  ///< The size of mTexture.
+        Size mDeclaredSize{};               ///< A size declared by the application, used instead of the frame size.
+        Color mPlaceholderColor{};          ///< The color drawn until the first frame arrives.
+
+        AnimationProtocol::slot_type mAnimationSlot{};  ///< Connection to the animation signal.
+
+        /**
+         * @brief Upload the latest frame, if there is a new one.
+         */
+        void uploadFrame();
+
+    public:
+        VideoFrame() = default;
+        explicit VideoFrame(const std::shared_ptr<Theme>& theme) : Gadget(theme) {
+            mPlaceholderColor = theme->colorShades[ThemeColor::Bottom];
+        }
+        VideoFrame(const VideoFrame &) = delete;
+        VideoFrame(VideoFrame &&) = default;
+        VideoFrame &operator=(const VideoFrame &) = delete;
+        VideoFrame &operator=(VideoFrame &&) = default;
+        ~VideoFrame() override = default;
+
+        void initialize() override;
+
+        /// @return The mailbox producers post frames to.
+        [[nodiscard]] const std::shared_ptr<FrameMailbox> &mailbox() const { return mMailbox; }
+
+        /**
+         * @brief Declare the size of the video.
+         * @details Layout uses the declared size instead of the size of the first frame.
+         * @param size The size.
+         */
+        void setVideoSize(const Size &size) {
+            if (mDeclaredSize != size) {
+                mDeclaredSize = size;
+                setNeedsLayout();
+            }
+        }
+
+        bool initialLayout(Context &context) override;
+
+        void draw(Context &context, Point drawLocation) override;
+    };
+
+    inline void setParameter(std::shared_ptr<VideoFrame>& gadget, param::VideoSize size) {
+        gadget->setVideoSize(size.data);
+    }
+
+} // rose
+
+#endif //ROSE2_VIDEOFRAME_H
@@ -0,0 +1,95 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * WorkerPool.h Created by Richard Buckley (C) 18/10/26
+ */
+
+/**
+ * @file WorkerPool.h
+ * @author Richard Buckley <richard.buckley@ieee.org>
+ * @version 1.0
+ * @date 18/10/26
+ * @brief A pool of worker threads for work that must not hold up the event loop.
+ * @details A job runs on a worker thread and returns a completion. Completions are queued and run on the UI
+ * thread by the Application event loop, where it is safe to touch the renderer and the scene tree. Work that
+ * produces pixels, such as rasterizing text or decoding images, runs as a job and the completion uploads the
+ * result to a Texture.
+ */
+
+#ifndef ROSE2_WORKERPOOL_H
+#define ROSE2_WORKERPOOL_H
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rose {
+
+    /**
+     * @class WorkerPool
+     * @brief Run jobs on worker threads and their completions on the UI thread.
+     * @details The threads are started when the first job is submitted.
+     */
+    class WorkerPool {
+    public:
+        using Completion = std::function<void()>;      ///< Run on the UI thread after the job.
+        using Job = std::function<Completion()>;        ///< Run on a worker thread, may return an empty Completion.
+
+    protected:
+        std::size_t mThreadCount{};                 ///< The number of worker threads to start.
+        std::vector<std::thread> mThreads{};        ///< The worker threads.
+        std::mutex mJobMutex{};                     ///< Protects mJobs and mStop.
+        std::condition_variable mJobReady{};        ///< Signalled when a job is queued or the pool stops.
+        std::deque<Job> mJobs{};                    ///< Jobs waiting for a worker.
+        bool mStop{false};                          ///< Set to stop the workers.
+
+        std::mutex mCompletionMutex{};              ///< Protects mCompletions.
+        std::deque<Completion> mCompletions{};      ///< Completions waiting for the UI thread.
+
+        /**
+         * @brief The worker thread body.
+         */
+        void worker();
+
+    public:
+        /**
+         * @brief Constructor.
+         * @param threadCount The number of worker threads, zero to choose from the hardware concurrency.
+         */
+        explicit WorkerPool(std::size_t threadCount = 0);
+
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool(WorkerPool&&) = delete;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+        WorkerPool& operator=(WorkerPool&&) = delete;
+
+        /**
+         * @brief Destructor. Queued jobs are abandoned, running jobs are finished and the workers joined.
+         */
+        ~WorkerPool();
+
+        /**
+         * @brief Queue a job.
+         * @param job The job.
+         */
+        void submit(Job job);
+
+        /**
+         * @brief Run queued completions on the calling thread, which should be the UI thread.
+         * @details Completions are run until none remain or the time budget is spent, the rest wait for the
+         * next call. An exception thrown by a completion is reported and does not stop the others.
+         * @param budget The time budget.
+         * @return The number of completions run.
+         */
+        std::size_t runCompletions(std::chrono::milliseconds budget = std::chrono::milliseconds{8});
+    };
+
+} // rose
+
+#endif //ROSE2_WORKERPOOL_H
@@ -0,0 +1,75 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * XDGBaseDir.h Created by Richard Buckley (C) 18/10/26
+ */
+
+/**
+ * @file XDGBaseDir.h
+ * @author Richard Buckley <richard.buckley@ieee.org>
+ * @version 1.0
+ * @date 18/10/26
+ * @brief Locations defined by the XDG Base Directory specification.
+ * @details See <a href="https://specifications.freedesktop.org/basedir-spec/basedir-spec-latest.html">
+ * XDG Base Directory</a>.
+ */
+
+#ifndef ROSE2_XDGBASEDIR_H
+#define ROSE2_XDGBASEDIR_H
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace rose {
+
+    /**
+     * @brief Thrown when an XDG Base Directory location can not be determined or created.
+     */
+    class XDGPathError : public std::runtime_error {
+    public:
+        explicit XDGPathError(const std::string &what_arg) : std::runtime_error(what_arg) {}
+
+        [[maybe_unused]] explicit XDGPathError(const char *what_arg) : std::runtime_error(what_arg) {}
+    };
+
+    /**
+     * @brief Get the base directory for user specific non-essential data.
+     * @details The value of $XDG_CACHE_HOME if it is set to an absolute path, otherwise $HOME/.cache.
+     * @return The cache home path.
+     * @throws XDGPathError if neither $XDG_CACHE_HOME nor $HOME is usable.
+     */
+    std::filesystem::path xdgCacheHome();
+
+    /**
+     * @brief Get a Rose cache directory, creating it if required.
+     * @param subdirectory The name of the cache within the Rose cache directory.
+     * @return The path $XDG_CACHE_HOME/Rose2/subdirectory.
+     * @throws XDGPathError if the directory can not be created.
+     */
+    std::filesystem::path roseCacheDirectory(std::string_view subdirectory);
+
+    /**
+     * @brief A stable hash used to name cache files.
+     * @param string The string to hash.
+     * @return The 64 bit FNV-1a hash of the string.
+     */
+    uint64_t fnv1a(std::string_view string);
+
+    /**
+     * @brief Name the cached form of a file.
+     * @details The name is the FNV-1a hash of the path, modification time and size of the file, so it changes
+     * whenever the file does.
+     * @param path The file path.
+     * @return A 16 hex digit name, or std::nullopt if the file does not exist.
+     */
+    std::optional<std::string> fileCacheKey(const std::filesystem::path &path);
+
+} // rose
+
+#endif //ROSE2_XDGBASEDIR_H
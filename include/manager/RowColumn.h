@@ -19,6 +19,7 @@
 #define ROSE2_ROWCOLUMN_H
 
 #include "Widget.h"
+#include <utility>
 
 namespace rose {
 
@@ -43,6 +44,22 @@ namespace rose {
 
         ScreenCoordType mMajorAxisSize{};       ///< Total size of the major axis.
         ScreenCoordType mMinorAxisMax{};        ///< The minor axis maximum Gadget size.
+        ScreenCoordType mFixedMajorSize{-1};    ///< Major axis size of Gadgets not wanting the last constraint.
+
+        /**
+         * @brief Get the major axis size of a Gadget.
+         */
+        [[nodiscard]] ScreenCoordType majorSize(const std::shared_ptr<Gadget> &gadget) const {
+            auto &size = gadget->getVisualMetrics().clipRectangle.size;
+            return mMajorAxis == MajorAxis::HORIZONTAL ? size.w : size.h;
+        }
+
+        /**
+         * @brief Total the major axis size of the Gadgets that do not want a constraint.
+         * @param gadgets The managed Gadgets.
+         * @return The total size, and the number of Gadgets that want a constraint.
+         */
+        std::pair<ScreenCoordType, int> fixedMajorSize(const std::vector<std::shared_ptr<Gadget>> &gadgets) const;
 
     public:
         LinearLayout() = default;
@@ -68,6 +85,16 @@ namespace rose {
          * @return true on success, false on fail.
          */
         bool initialWidgetLayout(Context &context, std::shared_ptr<Gadget> &gadget) override;
+
+        /**
+         * @brief Share the major axis of the constraint among the Gadgets that want it.
+         * @details The space left after the Gadgets that do not want a constraint is divided evenly among the
+         * Gadgets that do. Every Gadget gets the whole minor axis.
+         * @param context The graphics Context.
+         * @param widget The Widget.
+         * @param interior The space available inside the Widget's padding.
+         */
+        void constrainedWidgetLayout(Context &context, std::shared_ptr<Widget> &widget, Size interior) override;
     };
 
     /**
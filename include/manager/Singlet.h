@@ -52,6 +52,15 @@ namespace rose {
 
         bool initialLayout(Context &context) override;
 
+        /**
+         * @brief Pass a layout constraint on to the managed Gadget.
+         * @param context The graphics Context.
+         * @param constraint The space available to the Singlet.
+         */
+        void constrainedGadgetLayout(Context &context, Size constraint) override;
+
+        [[nodiscard]] bool wantsConstraint() const override { return mGadget && mGadget->wantsConstraint(); }
+
         /**
          * @brief Set internal alignment padding.
          * @details Internal alignment padding is used to align Gadgets inside of manager. Internal alignment
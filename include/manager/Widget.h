@@ -53,6 +53,15 @@ namespace rose {
 
         bool initialLayout(Context &context) override;
 
+        /**
+         * @brief Pass a layout constraint on to the managed Gadgets.
+         * @param context The graphics Context.
+         * @param constraint The space available to the Widget.
+         */
+        void constrainedGadgetLayout(Context &context, Size constraint) override;
+
+        [[nodiscard]] bool wantsConstraint() const override;
+
         template<class Layout>
         requires std::derived_from<LayoutManager,Layout>
         void setLayoutManager(std::unique_ptr<Layout>&& layout) {
@@ -168,6 +177,15 @@ namespace rose {
          * @return true on success, false on fail.
          */
         virtual bool initialWidgetLayout(Context &context, std::shared_ptr<Gadget> &gadget);
+
+        /**
+         * @brief Pass a layout constraint on to the Gadgets managed by a Widget.
+         * @details The default gives each Gadget the whole interior of the Widget.
+         * @param context The graphics Context.
+         * @param widget The Widget.
+         * @param interior The space available inside the Widget's padding.
+         */
+        virtual void constrainedWidgetLayout(Context &context, std::shared_ptr<Widget> &widget, Size interior);
     };
 
 } // rose
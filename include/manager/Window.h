@@ -56,6 +56,14 @@ namespace rose {
             return Widget::initialLayout(context);
         }
 
+        /**
+         * @brief Pass the Window size on to the managed Gadgets as a constraint, then layout the tree again so
+         * managers take the constrained sizes into account.
+         * @param context The graphics Context.
+         * @param constraint The Window size.
+         */
+        void constrainedGadgetLayout(Context &context, Size constraint) override;
+
         ~Screen() override = default;
 
         /**
@@ -87,6 +95,7 @@ namespace rose {
     class Window : public std::enable_shared_from_this<Window> {
         bool mNeedsLayout{true};            ///< True if window or a contained Gadget needs layout.
         bool mNeedsDrawing{true};           ///< True if window or a contained Gadget needs drawing.
+        Size mConstrainedSize{};            ///< The window size passed in the last constrained layout.
 
         SdlWindow mSdlWindow{};
         Context mContext{};
@@ -112,7 +121,12 @@ namespace rose {
         Window& operator=(const Window &) = delete;
         Window& operator=(Window &&) = default;
 
-        ~Window() = default;
+        /**
+         * @brief Destructor.
+         * @details Textures cached by the Application for this Window's renderer are released before it is
+         * destroyed.
+         */
+        ~Window();
 
         void initializeSceneTree();
 
@@ -244,6 +258,20 @@ namespace rose {
          */
         [[maybe_unused]] void setFocusGadget(std::shared_ptr<Gadget> &gadget);
 
+        /**
+         * @brief Send a keyboard event to the Gadget at the front of the focus chain.
+         * @param e The SDL_KeyboardEvent.
+         * @return true if the event was processed.
+         */
+        bool keyboardEvent(const SDL_KeyboardEvent &e);
+
+        /**
+         * @brief Send a text input event to the Gadget at the front of the focus chain.
+         * @param e The SDL_TextInputEvent.
+         * @return true if the event was processed.
+         */
+        bool textInputEvent(const SDL_TextInputEvent &e);
+
         /**
          * @brief Preorder traversal of a Widget tree to apply a lambda to each Gadget.
          * @details The tree is traversed starting from the specified Gadget. Gadgets which are also Widgets are
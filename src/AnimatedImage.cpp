@@ -0,0 +1,153 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * AnimatedImage.cpp Created by Richard Buckley (C) 18/10/26
+ */
+
+#include "AnimatedImage.h"
+#include <Application.h>
+#include <ImageDecode.h>
+
+namespace rose {
+
+    void AnimatedImage::initialize() {
+        Gadget::initialize();
+        mAnimationSlot = AnimationProtocol::createSlot();
+        mAnimationSlot->receiver = [this](uint64_t ticks) { advance(ticks); };
+        if (auto application = getApplicationPtr(); application)
+            application->animationSignal.connect(mAnimationSlot);
+    }
+
+    void AnimatedImage::setFilePath(const std::filesystem::path &path) {
+        if (mImageFilePath != path) {
+            mImageFilePath = path;
+            mDecoder.reset();
+            mFrames.clear();
+            mSpare.clear();
+            mDecodeInFlight = false;
+            mFinished = false;
+            mFrameTick = 0;
+            ++mGeneration;
+            setNeedsLayout();
+            setNeedsDrawing();
+        }
+    }
+
+    std::size_t AnimatedImage::ringSize() const {
+        if (!mDecoder)
+            return MinFrames;
+        auto size = mDecoder->size();
+        auto frameBytes = static_cast<std::size_t>(size.w) * static_cast<std::size_t>(size.h) * 4;
+        return std::clamp(mFrameBudget / std::max(frameBytes, std::size_t{1}), MinFrames, MaxFrames);
+    }
+
+    void AnimatedImage::requestFrame() {
+        auto application = getApplicationPtr();
+        if (mDecodeInFlight || mFinished || mImageFilePath.empty() || !application || mFrames.size() >= ringSize())
+            return;
+        mDecodeInFlight = true;
+
+        std::weak_ptr<Gadget> weak = shared_from_this();
+        auto generation = mGeneration;
+        application->workerPool().submit([weak, decoder = mDecoder, path = mImageFilePath, generation]() mutable
+                                                 -> WorkerPool::Completion {
+            auto frame = std::make_shared<std::optional<GifDecoder::Frame>>();
+            std::string error{};
+            try {
+                if (!decoder)
+                    decoder = std::make_shared<GifDecoder>(path);
+                *frame = decoder->next();
+            } catch (const std::exception &e) {
+                error = e.what();
+            }
+            return [weak, decoder, frame, error, generation]() {
+                if (auto image = std::dynamic_pointer_cast<AnimatedImage>(weak.lock()); image)
+                    image->frameReady(decoder, *frame, error, generation);
+            };
+        });
+    }
+
+    void AnimatedImage::frameReady(const std::shared_ptr<GifDecoder> &decoder, std::optional<GifDecoder::Frame> &frame,
+                                   const std::string &error, uint64_t generation) {
+        if (generation != mGeneration)
+            return;
+        mDecodeInFlight = false;
+        mDecoder = decoder;
+        auto window = getWindow();
+        if (!window)
+            return;
+
+        if (!error.empty())
+            fmt::print("{}\n", error);
+        if (!frame || !frame->image) {
+            mFinished = true;
+            return;
+        }
+
+        auto &image = frame->image;
+        Texture texture{};
+        if (!mSpare.empty()) {
+            texture = std::move(mSpare.back());
+            mSpare.pop_back();
+        } else {
+            texture = Texture{window->context(), SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, image->w,
+                              image->h};
+            if (!texture) {
+                fmt::print("Animation frame texture error: {}\n", SDL_GetError());
+                mFinished = true;
+                return;
+            }
+            texture.setBlendMode(SDL_BLENDMODE_BLEND);
+        }
+        SDL_UpdateTexture(texture.get(), nullptr, image->pixels, image->pitch);
+        mFrames.push_back(RingFrame{std::move(texture), frame->delay});
+
+        if (mFrames.size() == 1)
+            setNeedsDrawing();
+        requestFrame();
+    }
+
+    void AnimatedImage::advance(uint64_t ticks) {
+        // The first frame starts showing when it is drawn, the next must be decoded before it can be shown.
+        if (mFrameTick == 0 || mFrames.size() < 2 || ticks - mFrameTick < mFrames.front().delay)
+            return;
+
+        // Keep to the timing of the file, unless so far behind that frames would be skipped.
+        mFrameTick += mFrames.front().delay;
+        if (ticks - mFrameTick >= mFrames[1].delay)
+            mFrameTick = ticks;
+
+        if (mSpare.size() + mFrames.size() <= ringSize())
+            mSpare.push_back(std::move(mFrames.front().texture));
+        mFrames.pop_front();
+        setNeedsDrawing();
+        requestFrame();
+    }
+
+    bool AnimatedImage::initialLayout(Context &context) {
+        if (!mImageFilePath.empty())
+            mVisualMetrics.desiredSize = imageFileSize(mImageFilePath).value_or(Size{});
+        return Gadget::initialLayout(context);
+    }
+
+    void AnimatedImage::draw(Context &context, Point drawLocation) {
+        Gadget::draw(context, drawLocation);
+        auto renderRect = mVisualMetrics.renderRect + drawLocation;
+        if (!context.isVisible(renderRect))
+            return;
+
+        if (mFrames.empty()) {
+            requestFrame();
+            if (mPlaceholderColor)
+                context.fillRect(renderRect, mPlaceholderColor);
+            return;
+        }
+
+        if (mFrameTick == 0)
+            mFrameTick = SDL_GetTicks64();
+        context.renderCopy(mFrames.front().texture, renderRect);
+    }
+
+} // rose
@@ -37,7 +37,10 @@ namespace rose {
                 event.onEvent(e);
             }
 
+            mWorkerPool.runCompletions();
             animationSignal.transmit(SDL_GetTicks64());
+            if (mNeedsLayout)
+                applicationLayout();
             if (mNeedsDrawing)
                 applicationDraw();
 
@@ -45,6 +48,16 @@ namespace rose {
         }
     }
 
+    void Application::applicationLayout() {
+        mNeedsLayout = false;
+        for (const auto &window : mWindows) {
+            if (window->needsLayout()) {
+                window->layout();
+                window->setNeedsDrawing();
+            }
+        }
+    }
+
     void Application::applicationDraw() {
         for (const auto &window : mWindows) {
             window->draw();
@@ -70,9 +83,17 @@ namespace rose {
 
         event.setMouseButton([this](const SDL_MouseButtonEvent &e) -> bool { return handleMouseButtonEvent(e); });
 
+        event.setMouseWheel([this](const SDL_MouseWheelEvent &e) -> bool { return handleMouseWheelEvent(e); });
+
+        event.setFingerTouch([this](const SDL_TouchFingerEvent &e) -> bool { return handleFingerTouchEvent(e); });
+
         event.setWinSizeChange([this](WindowEventType windowEventType, const SDL_WindowEvent &e) -> void {
             winSizeChange(windowEventType, e); });
 
+        event.setKeEvent([this](const SDL_KeyboardEvent &e) -> bool { return handleKeyboardEvent(e); });
+
+        event.setTextInput([this](const SDL_TextInputEvent &e) -> bool { return handleTextInputEvent(e); });
+
         return rose::GraphicsModel::initialize();
     }
 
@@ -115,12 +136,15 @@ namespace rose {
         if ((e.state & (SDL_BUTTON_LMASK | SDL_BUTTON_RMASK | SDL_BUTTON_MMASK)) == 0) {
             // Process enter and leave events.
             if (auto gadget = validateMouseGadget(Point{e.x, e.y}, e.timestamp)) {
+                gadget->mouseMotionEvent(e);
                 return true;
             }
         } else {
-            // Process drag events which may generate enter and leave events when drag is not supported.
+            // Drag events go to the Gadget that received the button press, if it accepts them.
+            if (auto gadget = mButtonGadget.lock(); gadget && gadget->mouseMotionEvent(e))
+                return true;
+            // Otherwise they may generate enter and leave events.
             if (auto gadget = validateMouseGadget(Point{e.x, e.y}, e.timestamp)) {
-                // ToDo: Implement drag event.
                 return true;
             }
         }
@@ -129,8 +153,54 @@ namespace rose {
 
     bool Application::handleMouseButtonEvent(const SDL_MouseButtonEvent &e) {
         if (auto gadget = validateMouseGadget(Point{e.x, e.y}, e.timestamp); gadget) {
+            if (e.type == SDL_MOUSEBUTTONDOWN)
+                mButtonGadget = gadget;
+            else
+                mButtonGadget.reset();
             return gadget->mouseButtonEvent(e);
         }
+        mButtonGadget.reset();
+        return false;
+    }
+
+    bool Application::handleMouseWheelEvent(const SDL_MouseWheelEvent &e) {
+        if (auto gadget = mMouseGadget.lock(); gadget)
+            return gadget->mouseWheelEvent(e);
+        return false;
+    }
+
+    bool Application::handleFingerTouchEvent(const SDL_TouchFingerEvent &e) {
+        if (e.type == SDL_FINGERDOWN && mTouchGadget.expired()) {
+            auto winId = [e](const std::shared_ptr<Window>& w) { return w->windowID() == e.windowID; };
+            if (auto window = std::ranges::find_if(mWindows, winId); window != mWindows.end()) {
+                int w{}, h{};
+                SDL_GetWindowSize((*window)->sdlWindow().get(), &w, &h);
+                Point point{static_cast<int>(e.x * static_cast<float>(w)), static_cast<int>(e.y * static_cast<float>(h))};
+                mTouchGadget = (*window)->findGadget([&point](std::shared_ptr<Gadget> &gadget) -> bool {
+                    return gadget->containsPoint(point);
+                });
+            }
+        }
+
+        auto gadget = mTouchGadget.lock();
+        if (e.type == SDL_FINGERUP && SDL_GetNumTouchFingers(e.touchId) == 0)
+            mTouchGadget.reset();
+        if (gadget)
+            return gadget->fingerTouchEvent(e);
+        return false;
+    }
+
+    bool Application::handleKeyboardEvent(const SDL_KeyboardEvent &e) {
+        auto winId = [e](const std::shared_ptr<Window>& w) { return w->windowID() == e.windowID; };
+        if (auto window = std::ranges::find_if(mWindows,winId); window != mWindows.end())
+            return (*window)->keyboardEvent(e);
+        return false;
+    }
+
+    bool Application::handleTextInputEvent(const SDL_TextInputEvent &e) {
+        auto winId = [e](const std::shared_ptr<Window>& w) { return w->windowID() == e.windowID; };
+        if (auto window = std::ranges::find_if(mWindows,winId); window != mWindows.end())
+            return (*window)->textInputEvent(e);
         return false;
     }
 
@@ -0,0 +1,206 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * BitmapFont.cpp Created by Richard Buckley (C) 18/10/26
+ */
+
+#include "BitmapFont.h"
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <optional>
+#include <sstream>
+#include <vector>
+
+namespace rose {
+
+    namespace {
+        /**
+         * @struct BDFGlyph
+         * @brief A glyph as read from a BDF file, before it is packed into the strip.
+         */
+        struct BDFGlyph {
+            char32_t code{};
+            int advance{};
+            int width{}, height{}, xOffset{}, yOffset{};
+            std::vector<uint8_t> bits{};        ///< Rows of (width + 7) / 8 bytes, most significant bit first.
+        };
+
+        /**
+         * @brief Convert a row of hexadecimal digits to bytes.
+         * @param hex The digits.
+         * @param bytes Where to put the bytes.
+         * @param count The number of bytes expected.
+         * @return True on success.
+         */
+        bool hexRow(std::string_view hex, std::vector<uint8_t> &bytes, std::size_t count) {
+            if (hex.size() < count * 2)
+                return false;
+            for (std::size_t idx = 0; idx < count; ++idx) {
+                uint8_t byte{};
+                auto digits = hex.substr(idx * 2, 2);
+                if (std::from_chars(digits.data(), digits.data() + 2, byte, 16).ec != std::errc{})
+                    return false;
+                bytes.push_back(byte);
+            }
+            return true;
+        }
+    }
+
+    BitmapFont::BitmapFont(const std::filesystem::path &path) : mName(path.string()) {
+        readBDF(path);
+    }
+
+    void BitmapFont::readBDF(const std::filesystem::path &path) {
+        std::ifstream strm{path};
+        if (!strm)
+            throw BitmapFontException(fmt::format("Can not open bitmap font '{}'", path.string()));
+
+        std::vector<BDFGlyph> glyphs{};
+        BDFGlyph current{};
+        int boxHeight{}, boxY{};
+        std::optional<int> ascent{}, descent{}, defaultChar{};
+        bool inChar{false};
+        int bitmapRows{-1};
+
+        std::string line{};
+        while (std::getline(strm, line)) {
+            if (bitmapRows >= 0) {
+                if (line.starts_with("ENDCHAR")) {
+                    bitmapRows = -1;
+                    inChar = false;
+                    if (current.code != static_cast<char32_t>(-1)) {
+                        current.bits.resize(static_cast<std::size_t>((current.width + 7) / 8 * current.height));
+                        glyphs.push_back(std::move(current));
+                    }
+                    current = BDFGlyph{};
+                } else if (bitmapRows < current.height) {
+                    auto rowBytes = static_cast<std::size_t>((current.width + 7) / 8);
+                    if (!hexRow(line, current.bits, rowBytes))
+                        throw BitmapFontException(fmt::format("Bad bitmap row in '{}'", path.string()));
+                    ++bitmapRows;
+                }
+                continue;
+            }
+
+            std::istringstream fields{line};
+            std::string keyword{};
+            fields >> keyword;
+            if (keyword == "FONTBOUNDINGBOX") {
+                int w{}, x{};
+                fields >> w >> boxHeight >> x >> boxY;
+            } else if (keyword == "FONT_ASCENT") {
+                int value{};
+                if (fields >> value)
+                    ascent = value;
+            } else if (keyword == "FONT_DESCENT") {
+                int value{};
+                if (fields >> value)
+                    descent = value;
+            } else if (keyword == "DEFAULT_CHAR") {
+                int value{};
+                if (fields >> value)
+                    defaultChar = value;
+            } else if (keyword == "STARTCHAR") {
+                inChar = true;
+                current = BDFGlyph{};
+            } else if (inChar && keyword == "ENCODING") {
+                int value{-1};
+                fields >> value;
+                current.code = static_cast<char32_t>(value);
+            } else if (inChar && keyword == "DWIDTH") {
+                fields >> current.advance;
+            } else if (inChar && keyword == "BBX") {
+                fields >> current.width >> current.height >> current.xOffset >> current.yOffset;
+            } else if (inChar && keyword == "BITMAP") {
+                if (current.width < 0 || current.height < 0)
+                    throw BitmapFontException(fmt::format("Bad glyph box in '{}'", path.string()));
+                bitmapRows = 0;
+            }
+        }
+
+        if (glyphs.empty())
+            throw BitmapFontException(fmt::format("No glyphs in bitmap font '{}'", path.string()));
+
+        mAscent = ascent.value_or(boxHeight + boxY);
+        mDescent = descent.value_or(-boxY);
+
+        // Pack the glyphs in rows of equal height.
+        int rowHeight = 1;
+        for (const auto &g : glyphs)
+            rowHeight = std::max(rowHeight, g.height);
+        int x = 0, rows = 1, stripWidth = 1;
+        std::vector<Point> positions{};
+        positions.reserve(glyphs.size());
+        for (const auto &g : glyphs) {
+            if (x + g.width > StripWidth && x > 0) {
+                x = 0;
+                ++rows;
+            }
+            positions.emplace_back(x, (rows - 1) * rowHeight);
+            x += g.width;
+            stripWidth = std::max(stripWidth, x);
+        }
+
+        mStrip = Surface{stripWidth, rows * rowHeight};
+        mStrip.setBlendMode(SDL_BLENDMODE_BLEND);
+        SDL_FillRect(mStrip.get(), nullptr, SDL_MapRGBA(mStrip->format, 255, 255, 255, 0));
+        auto ink = SDL_MapRGBA(mStrip->format, 255, 255, 255, 255);
+
+        mGlyphs.reserve(glyphs.size());
+        for (std::size_t idx = 0; idx < glyphs.size(); ++idx) {
+            const auto &g = glyphs[idx];
+            auto rowBytes = static_cast<std::size_t>((g.width + 7) / 8);
+            for (int row = 0; row < g.height; ++row) {
+                for (int col = 0; col < g.width; ++col) {
+                    auto byte = g.bits[static_cast<std::size_t>(row) * rowBytes + static_cast<std::size_t>(col / 8)];
+                    if (byte & (0x80u >> static_cast<unsigned>(col % 8)))
+                        mStrip.pixel(positions[idx].x + col, positions[idx].y + row) = ink;
+                }
+            }
+            mGlyphs[g.code] = BitmapGlyph{Rectangle{positions[idx].x, positions[idx].y, g.width, g.height},
+                                          Point{g.xOffset, mAscent - (g.height + g.yOffset)}, g.advance};
+        }
+
+        if (defaultChar) {
+            if (auto found = mGlyphs.find(static_cast<char32_t>(defaultChar.value())); found != mGlyphs.end())
+                mDefaultGlyph = &found->second;
+        }
+        if (!mDefaultGlyph) {
+            if (auto found = mGlyphs.find(U'?'); found != mGlyphs.end())
+                mDefaultGlyph = &found->second;
+        }
+    }
+
+    const BitmapGlyph *BitmapFont::glyph(char32_t code) const {
+        if (auto found = mGlyphs.find(code); found != mGlyphs.end())
+            return &found->second;
+        return mDefaultGlyph;
+    }
+
+    Size BitmapFont::textSize(std::string_view text) const {
+        Size size{0, height()};
+        for (std::size_t idx = 0; idx < text.size();) {
+            if (auto g = glyph(utf8Next(text, idx)); g)
+                size.w += g->advance;
+        }
+        return size;
+    }
+
+    void BitmapFont::render(Context &context, Texture &strip, std::string_view text, Point point,
+                            const Color &color) const {
+        strip.setColorMod(color);
+
+        for (std::size_t idx = 0; idx < text.size();) {
+            if (auto g = glyph(utf8Next(text, idx)); g) {
+                if (g->rect.size.w > 0 && g->rect.size.h > 0)
+                    context.renderCopy(strip, g->rect, Rectangle{point.x + g->offset.x, point.y + g->offset.y,
+                                                                 g->rect.size.w, g->rect.size.h});
+                point.x += g->advance;
+            }
+        }
+    }
+
+} // rose
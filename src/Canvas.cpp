@@ -0,0 +1,122 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * Canvas.cpp Created by Richard Buckley (C) 18/10/26
+ */
+
+#include "Canvas.h"
+#include <Application.h>
+
+namespace rose {
+
+    void Canvas::initialize() {
+        Gadget::initialize();
+        mAnimationSlot = AnimationProtocol::createSlot();
+        mAnimationSlot->receiver = [this](uint64_t ticks) { update(ticks); };
+        if (auto application = getApplicationPtr(); application)
+            application->animationSignal.connect(mAnimationSlot);
+    }
+
+    void Canvas::setCanvasSize(const Size &size) {
+        if (mCanvasSize == size)
+            return;
+        mCanvasSize = size;
+        mPitch = (size.w + PitchAlignment - 1) / PitchAlignment * PitchAlignment;
+        mPixels = std::make_shared<std::vector<uint32_t>>(
+                static_cast<std::size_t>(mPitch) * static_cast<std::size_t>(std::max(size.h, 0)));
+        mTextures = std::array<Texture, 2>{};
+        mFront = 0;
+        // A new back Texture is entirely out of date.
+        mStaleFirst = 0;
+        mStaleLast = size.h;
+        mUpdateInFlight = false;
+        mUpdateRequested = true;
+        ++mGeneration;
+        setNeedsLayout();
+    }
+
+    void Canvas::update(uint64_t ticks) {
+        if (!(mUpdateRequested || mContinuous) || mUpdateInFlight || !mDrawCallback || !mPixels || !mCanvasSize)
+            return;
+        mUpdateRequested = false;
+
+        auto application = getApplicationPtr();
+        auto generation = mGeneration;
+        if (!mOnWorker || !application) {
+            PixelSpan span{mPixels->data(), mPitch, mCanvasSize};
+            mDrawCallback(span, ticks);
+            updateDone(span.dirtyFirst, span.dirtyLast, generation);
+            return;
+        }
+
+        // The job shares the buffer, the UI thread does not touch it until the completion runs.
+        mUpdateInFlight = true;
+        std::weak_ptr<Gadget> weak = shared_from_this();
+        application->workerPool().submit([weak, callback = mDrawCallback, pixels = mPixels, pitch = mPitch,
+                                          size = mCanvasSize, ticks, generation]() -> WorkerPool::Completion {
+            PixelSpan span{pixels->data(), pitch, size};
+            try {
+                callback(span, ticks);
+            } catch (const std::exception &e) {
+                // The completion still runs so the Canvas is not left waiting for this update.
+                fmt::print("Canvas draw error: {}\n", e.what());
+            }
+            return [weak, first = span.dirtyFirst, last = span.dirtyLast, generation]() {
+                if (auto canvas = std::dynamic_pointer_cast<Canvas>(weak.lock()); canvas)
+                    canvas->updateDone(first, last, generation);
+            };
+        });
+    }
+
+    void Canvas::updateDone(int dirtyFirst, int dirtyLast, uint64_t generation) {
+        if (generation != mGeneration)
+            return;
+        mUpdateInFlight = false;
+        auto window = getWindow();
+        if (!window || dirtyFirst >= dirtyLast)
+            return;
+
+        // The back Texture missed the previous update as well as this one.
+        auto first = mStaleFirst < mStaleLast ? std::min(dirtyFirst, mStaleFirst) : dirtyFirst;
+        auto last = mStaleFirst < mStaleLast ? std::max(dirtyLast, mStaleLast) : dirtyLast;
+
+        auto &back = mTextures[1 - mFront];
+        if (!back) {
+            back = Texture{window->context(), SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING,
+                           mCanvasSize.w, mCanvasSize.h};
+            if (!back) {
+                fmt::print("Canvas texture error: {}\n", SDL_GetError());
+                return;
+            }
+            back.setBlendMode(SDL_BLENDMODE_BLEND);
+            first = 0;
+            last = mCanvasSize.h;
+        }
+
+        SDL_Rect rows{0, first, mCanvasSize.w, last - first};
+        auto pixels = mPixels->data() + static_cast<std::ptrdiff_t>(first) * mPitch;
+        if (SDL_UpdateTexture(back.get(), &rows, pixels, mPitch * static_cast<int>(sizeof(uint32_t)))) {
+            fmt::print("Canvas upload error: {}\n", SDL_GetError());
+            return;
+        }
+
+        mFront = 1 - mFront;
+        mStaleFirst = dirtyFirst;
+        mStaleLast = dirtyLast;
+        setNeedsDrawing();
+    }
+
+    bool Canvas::initialLayout(Context &context) {
+        mVisualMetrics.desiredSize = mCanvasSize;
+        return Gadget::initialLayout(context);
+    }
+
+    void Canvas::draw(Context &context, Point drawLocation) {
+        Gadget::draw(context, drawLocation);
+        if (auto &front = mTextures[mFront]; front)
+            context.renderCopy(front, mVisualMetrics.renderRect + drawLocation);
+    }
+
+} // rose
@@ -0,0 +1,136 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * FileWatcher.cpp Created by Richard Buckley (C) 18/10/26
+ */
+
+#include "FileWatcher.h"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <fmt/format.h>
+
+namespace rose {
+
+    namespace {
+        constexpr uint32_t WatchMask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_ONLYDIR;
+    }
+
+    FileWatcher::~FileWatcher() {
+        if (mThread.joinable()) {
+            uint64_t one = 1;
+            [[maybe_unused]] auto written = ::write(mWakeup, &one, sizeof(one));
+            mThread.join();
+        }
+        if (mInotify >= 0)
+            ::close(mInotify);
+        if (mWakeup >= 0)
+            ::close(mWakeup);
+    }
+
+    void FileWatcher::start() {
+        mInotify = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (mInotify < 0)
+            throw FileWatcherError(fmt::format("inotify_init1: {}", std::strerror(errno)));
+        mWakeup = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (mWakeup < 0) {
+            auto error = errno;
+            ::close(mInotify);
+            mInotify = -1;
+            throw FileWatcherError(fmt::format("eventfd: {}", std::strerror(error)));
+        }
+        mThread = std::thread{[this]() { run(); }};
+    }
+
+    FileWatcher::WatchToken FileWatcher::watch(const std::filesystem::path &path, WorkerPool::Job job) {
+        std::lock_guard lock{mMutex};
+        if (mInotify < 0)
+            start();
+
+        auto absolute = std::filesystem::absolute(path);
+        auto directory = absolute.parent_path();
+        auto descriptor = ::inotify_add_watch(mInotify, directory.c_str(), WatchMask);
+        if (descriptor < 0)
+            throw FileWatcherError(fmt::format("Can not watch '{}': {}", directory.string(), std::strerror(errno)));
+
+        auto token = std::make_shared<Watch>(Watch{absolute.filename().string(), std::move(job)});
+        auto &entry = mDirectories[descriptor];
+        entry.path = directory;
+        entry.watches.emplace_back(token);
+        return token;
+    }
+
+    std::vector<WorkerPool::Job> FileWatcher::changed(int descriptor, const std::string &name) {
+        std::vector<WorkerPool::Job> jobs{};
+        std::lock_guard lock{mMutex};
+        auto directory = mDirectories.find(descriptor);
+        if (directory == mDirectories.end())
+            return jobs;
+
+        auto &watches = directory->second.watches;
+        std::erase_if(watches, [](const std::weak_ptr<Watch> &watch) { return watch.expired(); });
+        if (watches.empty()) {
+            ::inotify_rm_watch(mInotify, descriptor);
+            mDirectories.erase(directory);
+            return jobs;
+        }
+
+        for (auto &weak : watches)
+            if (auto watch = weak.lock(); watch && (name.empty() || watch->name == name))
+                jobs.push_back(watch->job);
+        return jobs;
+    }
+
+    void FileWatcher::run() {
+        alignas(inotify_event) std::array<char, 4096> buffer{};
+        std::array<pollfd, 2> descriptors{pollfd{mInotify, POLLIN, 0}, pollfd{mWakeup, POLLIN, 0}};
+
+        while (true) {
+            if (::poll(descriptors.data(), descriptors.size(), -1) < 0) {
+                if (errno == EINTR)
+                    continue;
+                fmt::print("FileWatcher poll: {}\n", std::strerror(errno));
+                return;
+            }
+            if (descriptors[1].revents)
+                return;
+
+            ssize_t length;
+            while ((length = ::read(mInotify, buffer.data(), buffer.size())) > 0) {
+                for (ssize_t offset = 0; offset < length;) {
+                    auto event = reinterpret_cast<const inotify_event *>(buffer.data() + offset);
+                    offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+                    std::vector<WorkerPool::Job> jobs{};
+                    if (event->mask & IN_Q_OVERFLOW) {
+                        // Events were lost, treat every watched file as changed.
+                        std::vector<int> watched{};
+                        {
+                            std::lock_guard lock{mMutex};
+                            for (auto &[descriptor, directory] : mDirectories)
+                                watched.push_back(descriptor);
+                        }
+                        for (auto descriptor : watched)
+                            std::ranges::move(changed(descriptor, std::string{}), std::back_inserter(jobs));
+                    } else if (event->mask & IN_IGNORED) {
+                        std::lock_guard lock{mMutex};
+                        mDirectories.erase(event->wd);
+                    } else if (event->len > 0) {
+                        jobs = changed(event->wd, std::string{event->name});
+                    }
+
+                    for (auto &job : jobs)
+                        mWorkerPool.submit(std::move(job));
+                }
+            }
+        }
+    }
+
+} // rose
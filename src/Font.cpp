@@ -14,6 +14,348 @@
  */
 
 #include "Font.h"
+#include "XDGBaseDir.h"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <thread>
 
 namespace rose {
-} // rose
\ No newline at end of file
+
+    namespace {
+        /**
+         * @struct ScanResult
+         * @brief The fonts and directories found by scanning one directory.
+         */
+        struct ScanResult {
+            std::vector<std::pair<std::string, std::filesystem::path>> fonts{};
+            std::vector<FontIndex::DirectoryTime> directories{};
+        };
+
+        /**
+         * @brief Get the modification time of a directory.
+         * @param path The directory path.
+         * @return The modification time, or file_time_type::min() if it does not exist.
+         */
+        std::filesystem::file_time_type directoryTime(const std::filesystem::path &path) {
+            std::error_code ec{};
+            auto time = std::filesystem::last_write_time(path, ec);
+            return ec ? std::filesystem::file_time_type::min() : time;
+        }
+
+        /**
+         * @brief Scan a directory for font files.
+         * @param path The directory.
+         * @param recursive If true scan the directory tree, otherwise only the files in the directory.
+         * @return The ScanResult.
+         */
+        ScanResult scanDirectory(const std::filesystem::path &path, bool recursive) {
+            using namespace std::filesystem;
+            ScanResult result{};
+            result.directories.emplace_back(path, directoryTime(path));
+
+            auto addEntry = [&result](const directory_entry &entry) {
+                std::error_code ec{};
+                if (entry.is_directory(ec)) {
+                    if (!entry.is_symlink(ec))
+                        result.directories.emplace_back(entry.path(), directoryTime(entry.path()));
+                } else if (entry.is_regular_file(ec) && FontIndex::isFontFile(entry.path())) {
+                    result.fonts.emplace_back(entry.path().stem().string(), entry.path());
+                }
+            };
+
+            std::error_code ec{};
+            if (recursive) {
+                for (auto itr = recursive_directory_iterator(path, directory_options::skip_permission_denied, ec);
+                     !ec && itr != recursive_directory_iterator(); itr.increment(ec))
+                    addEntry(*itr);
+            } else {
+                for (auto itr = directory_iterator(path, directory_options::skip_permission_denied, ec);
+                     !ec && itr != directory_iterator(); itr.increment(ec))
+                    if (!itr->is_directory(ec))
+                        addEntry(*itr);
+            }
+
+            std::sort(result.fonts.begin(), result.fonts.end());
+            return result;
+        }
+    }
+
+    namespace {
+        /**
+         * @struct GlyphMetricsCache
+         * @brief Cached metrics of the glyphs used from each open font.
+         */
+        struct GlyphMetricsCache {
+            std::mutex mutex{};
+            std::unordered_map<const TTF_Font *, std::unordered_map<Uint32, GlyphMetrics>> fonts{};
+        };
+
+        GlyphMetricsCache &glyphMetricsCache() {
+            // Never destroyed, fonts held in static storage may be closed after it would be.
+            static auto *cache = new GlyphMetricsCache;
+            return *cache;
+        }
+    }
+
+    void purgeGlyphMetrics(TTF_Font *ttfFont) {
+        auto &cache = glyphMetricsCache();
+        std::lock_guard lock{cache.mutex};
+        cache.fonts.erase(ttfFont);
+    }
+
+    GlyphMetrics getGlyphMetrics32(const FontPointer &font, Uint32 glyph) {
+        GlyphMetrics gm{};
+        if (!font)
+            return gm;
+
+        auto &cache = glyphMetricsCache();
+        std::lock_guard lock{cache.mutex};
+        auto &glyphs = cache.fonts[font.get()];
+        if (auto found = glyphs.find(glyph); found != glyphs.end())
+            return found->second;
+
+        gm.fontMetrics.fontHeight = TTF_FontHeight(font.get());
+        gm.fontMetrics.fontAscent = TTF_FontAscent(font.get());
+        gm.fontMetrics.fontDescent = TTF_FontDescent(font.get());
+        gm.fontMetrics.fontLineSkip = TTF_FontLineSkip(font.get());
+        TTF_GlyphMetrics32(font.get(), glyph, &gm.minX, &gm.maxX, &gm.minY, &gm.maxY, &gm.advance);
+        glyphs.emplace(glyph, gm);
+        return gm;
+    }
+
+    std::shared_ptr<MappedFile> FontManager::mapFontFile(const std::filesystem::path &fontPath) {
+        auto key = fontPath.string();
+        if (auto found = mFontFiles.find(key); found != mFontFiles.end()) {
+            if (auto fontFile = found->second.lock(); fontFile)
+                return fontFile;
+        }
+
+        try {
+            auto fontFile = std::make_shared<MappedFile>(fontPath);
+            std::erase_if(mFontFiles, [](const auto &entry) { return entry.second.expired(); });
+            mFontFiles[key] = fontFile;
+            return fontFile;
+        } catch (const MappedFileError &e) {
+            fmt::print("{}\n", e.what());
+        }
+        return nullptr;
+    }
+
+    std::mutex& fontLifetimeMutex() {
+        // Never destroyed, fonts held by static caches are closed after function statics are destroyed.
+        static auto *mutex = new std::mutex;
+        return *mutex;
+    }
+
+    FontPointer FontManager::openFont(const std::filesystem::path &fontPath, int ptSize) {
+        return openMappedFont(mapFontFile(fontPath), ptSize);
+    }
+
+    FontPointer openMappedFont(const std::shared_ptr<MappedFile> &fontFile, int ptSize) {
+        if (!fontFile || fontFile->size() > static_cast<std::size_t>(std::numeric_limits<int>::max()))
+            return nullptr;
+
+        auto rw = SDL_RWFromConstMem(fontFile->data(), static_cast<int>(fontFile->size()));
+        if (!rw) {
+            fmt::print("SDL_RWFromConstMem error: {}\n", SDL_GetError());
+            return nullptr;
+        }
+
+        // The RWops is closed with the font, the mapping is released by FontDestroy after that.
+        std::lock_guard lock{fontLifetimeMutex()};
+        if (auto ttfFont = TTF_OpenFontRW(rw, 1, ptSize); ttfFont)
+            return FontPointer{ttfFont, FontDestroy{fontFile}};
+
+        fmt::print("TTF_OpenFont error: {}\n", SDL_GetError());
+        return nullptr;
+    }
+
+    bool FontIndex::isFontFile(const std::filesystem::path &path) {
+        auto ext = path.extension().string();
+        return ext == ".ttf" || ext == ".otf" || ext == ".afm" || ext == ".t1" || ext == ".pfb" ||
+               isBitmapFontFile(path);
+    }
+
+    bool FontIndex::isBitmapFontFile(const std::filesystem::path &path) {
+        return path.extension() == ".bdf";
+    }
+
+    std::shared_ptr<BitmapFont> FontManager::getBitmapFont(std::string_view fontName) {
+        if (auto found = mBitmapFonts.find(fontName); found != mBitmapFonts.end())
+            return found->second;
+
+        std::shared_ptr<BitmapFont> bitmapFont{};
+        if (auto fontPath = getFontPath(fontName); fontPath && FontIndex::isBitmapFontFile(fontPath.value())) {
+            try {
+                bitmapFont = std::make_shared<BitmapFont>(fontPath.value());
+            } catch (const BitmapFontException &e) {
+                fmt::print("{}\n", e.what());
+            }
+        }
+        mBitmapFonts.emplace(std::string{fontName}, bitmapFont);
+        return bitmapFont;
+    }
+
+    std::optional<std::filesystem::path> FontIndex::indexFilePath() const {
+        std::string roots{};
+        for (const auto &root : mRoots) {
+            roots.append(root.string());
+            roots.push_back(':');
+        }
+
+        try {
+            return roseCacheDirectory("fonts") / fmt::format("{:016x}.idx", fnv1a(roots));
+        } catch (const XDGPathError &e) {
+            fmt::print("{}\n", e.what());
+        }
+        return std::nullopt;
+    }
+
+    void FontIndex::load(const std::vector<std::filesystem::path> &roots) {
+        mRoots = roots;
+        mFonts.clear();
+        mDirectories.clear();
+        mLoaded = true;
+
+        auto indexPath = indexFilePath();
+        if (indexPath && readIndex(indexPath.value()))
+            return;
+
+        rescan();
+        if (indexPath)
+            writeIndex(indexPath.value());
+    }
+
+    bool FontIndex::readIndex(const std::filesystem::path &indexPath) {
+        std::ifstream strm{indexPath};
+        if (!strm)
+            return false;
+
+        std::string line{};
+        if (!std::getline(strm, line) || line != IndexVersion)
+            return false;
+
+        std::vector<std::filesystem::path> roots{};
+        std::vector<DirectoryTime> directories{};
+        std::unordered_map<std::string, std::filesystem::path, StringHash, std::equal_to<>> fonts{};
+
+        while (std::getline(strm, line)) {
+            if (line.size() < 2 || line[1] != '\t')
+                return false;
+
+            auto field = std::string_view{line}.substr(2);
+            switch (line[0]) {
+                case 'R':
+                    roots.emplace_back(field);
+                    break;
+                case 'D': {
+                    auto tab = field.find('\t');
+                    if (tab == std::string_view::npos)
+                        return false;
+                    std::filesystem::file_time_type::rep count{};
+                    try {
+                        count = std::stoll(std::string{field.substr(0, tab)});
+                    } catch (const std::exception &) {
+                        return false;
+                    }
+                    directories.emplace_back(field.substr(tab + 1),
+                                             std::filesystem::file_time_type{std::filesystem::file_time_type::duration{count}});
+                    break;
+                }
+                case 'F': {
+                    auto tab = field.find('\t');
+                    if (tab == std::string_view::npos)
+                        return false;
+                    fonts.emplace(field.substr(0, tab), field.substr(tab + 1));
+                    break;
+                }
+                default:
+                    return false;
+            }
+        }
+
+        if (roots != mRoots)
+            return false;
+
+        for (const auto &[directory, time] : directories) {
+            if (directoryTime(directory) != time)
+                return false;
+        }
+
+        mFonts = std::move(fonts);
+        mDirectories = std::move(directories);
+        return true;
+    }
+
+    void FontIndex::writeIndex(const std::filesystem::path &indexPath) const {
+        auto tempPath = indexPath;
+        tempPath += fmt::format(".{}", std::hash<std::thread::id>{}(std::this_thread::get_id()));
+
+        {
+            std::ofstream strm{tempPath, std::ios::trunc};
+            if (!strm)
+                return;
+
+            auto writable = [](const std::string &s) { return s.find('\n') == std::string::npos; };
+
+            strm << IndexVersion << '\n';
+            for (const auto &root: mRoots)
+                strm << "R\t" << root.string() << '\n';
+            for (const auto &[directory, time]: mDirectories) {
+                if (writable(directory.string()))
+                    strm << "D\t" << time.time_since_epoch().count() << '\t' << directory.string() << '\n';
+            }
+            for (const auto &[name, path]: mFonts) {
+                if (writable(name) && name.find('\t') == std::string::npos && writable(path.string()))
+                    strm << "F\t" << name << '\t' << path.string() << '\n';
+            }
+            if (!strm)
+                return;
+        }
+
+        std::error_code ec{};
+        std::filesystem::rename(tempPath, indexPath, ec);
+        if (ec)
+            std::filesystem::remove(tempPath, ec);
+    }
+
+    void FontIndex::rescan() {
+        // Each root is scanned for the files it holds directly, each sub-directory of a root as a tree.
+        std::vector<std::pair<std::filesystem::path, bool>> work{};
+        for (const auto &root : mRoots) {
+            work.emplace_back(root, false);
+            std::error_code ec{};
+            for (auto itr = std::filesystem::directory_iterator(
+                    root, std::filesystem::directory_options::skip_permission_denied, ec);
+                 !ec && itr != std::filesystem::directory_iterator(); itr.increment(ec)) {
+                if (itr->is_directory(ec) && !itr->is_symlink(ec))
+                    work.emplace_back(itr->path(), true);
+            }
+        }
+
+        std::vector<ScanResult> results(work.size());
+        std::atomic_size_t next{0};
+        auto worker = [&work, &results, &next]() {
+            for (auto idx = next++; idx < work.size(); idx = next++)
+                results[idx] = scanDirectory(work[idx].first, work[idx].second);
+        };
+
+        auto threadCount = std::min<std::size_t>(std::max(1u, std::thread::hardware_concurrency()), work.size());
+        std::vector<std::thread> threads{};
+        for (std::size_t i = 1; i < threadCount; ++i)
+            threads.emplace_back(worker);
+        worker();
+        for (auto &thread : threads)
+            thread.join();
+
+        for (auto &result : results) {
+            for (auto &[name, path] : result.fonts)
+                mFonts.emplace(std::move(name), std::move(path));
+            std::move(result.directories.begin(), result.directories.end(), std::back_inserter(mDirectories));
+        }
+    }
+
+} // rose
@@ -96,6 +96,41 @@ namespace rose {
         return false;
     }
 
+    bool Gadget::mouseMotionEvent(const SDL_MouseMotionEvent &e) {
+        if (isManaged()) {
+            return manager.lock()->mouseMotionEvent(e);
+        }
+        return false;
+    }
+
+    bool Gadget::mouseWheelEvent(const SDL_MouseWheelEvent &e) {
+        if (isManaged()) {
+            return manager.lock()->mouseWheelEvent(e);
+        }
+        return false;
+    }
+
+    bool Gadget::fingerTouchEvent(const SDL_TouchFingerEvent &e) {
+        if (isManaged()) {
+            return manager.lock()->fingerTouchEvent(e);
+        }
+        return false;
+    }
+
+    bool Gadget::keyboardEvent(const SDL_KeyboardEvent &e) {
+        if (isManaged()) {
+            return manager.lock()->keyboardEvent(e);
+        }
+        return false;
+    }
+
+    bool Gadget::textInputEvent(const SDL_TextInputEvent &e) {
+        if (isManaged()) {
+            return manager.lock()->textInputEvent(e);
+        }
+        return false;
+    }
+
     void Gadget::setNeedsLayout() {
         mNeedsLayout = true;
         if (auto screenPtr = std::dynamic_pointer_cast<Screen>(shared_from_this()); screenPtr) {
@@ -169,6 +204,12 @@ namespace rose {
         return result;
     }
 
+    void LayoutManager::constrainedWidgetLayout(Context &context, std::shared_ptr<Widget> &widget, Size interior) {
+        for (auto &managed: getGadgetList(widget)) {
+            managed->constrainedGadgetLayout(context, interior);
+        }
+    }
+
     [[maybe_unused]] void ThemeBackgroundDecorator(Context &context, Gadget &gadget) {
         auto visualMetrics = gadget.getVisualMetrics();
         auto theme = gadget.getTheme();
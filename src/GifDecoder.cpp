@@ -0,0 +1,352 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * GifDecoder.cpp Created by Richard Buckley (C) 18/10/26
+ */
+
+#include "GifDecoder.h"
+#include <algorithm>
+#include <cstring>
+
+namespace rose {
+
+    namespace {
+        constexpr uint8_t ImageSeparator = 0x2C;
+        constexpr uint8_t ExtensionIntroducer = 0x21;
+        constexpr uint8_t Trailer = 0x3B;
+        constexpr uint8_t GraphicControlLabel = 0xF9;
+        constexpr uint8_t ApplicationLabel = 0xFF;
+
+        constexpr int DisposeBackground = 2;
+        constexpr int DisposePrevious = 3;
+
+        /**
+         * @brief Read a color table into ARGB values.
+         */
+        void readPalette(std::span<const uint8_t> table, std::array<uint32_t, 256> &palette) {
+            palette.fill(0xFF000000u);
+            for (std::size_t i = 0; i < table.size() / 3; ++i)
+                palette[i] = 0xFF000000u | static_cast<uint32_t>(table[3 * i]) << 16u |
+                             static_cast<uint32_t>(table[3 * i + 1]) << 8u | table[3 * i + 2];
+        }
+
+        /**
+         * @brief Map the rows of an interlaced image to their position.
+         */
+        std::vector<int> rowOrder(int height, bool interlaced) {
+            std::vector<int> rows{};
+            rows.reserve(static_cast<std::size_t>(height));
+            if (!interlaced) {
+                for (int y = 0; y < height; ++y)
+                    rows.push_back(y);
+                return rows;
+            }
+            static constexpr std::array<std::pair<int, int>, 4> Passes{{{0, 8}, {4, 8}, {2, 4}, {1, 2}}};
+            for (auto [start, step] : Passes)
+                for (int y = start; y < height; y += step)
+                    rows.push_back(y);
+            return rows;
+        }
+    }
+
+    GifDecoder::GifDecoder(const std::filesystem::path &path) {
+        try {
+            mFile = MappedFile{path};
+        } catch (const MappedFileError &e) {
+            throw GifDecoderError(e.what());
+        }
+        mData = std::span<const uint8_t>{reinterpret_cast<const uint8_t *>(mFile.data()), mFile.size()};
+
+        if (mData.size() < 13 || (std::memcmp(mData.data(), "GIF87a", 6) != 0 &&
+                                  std::memcmp(mData.data(), "GIF89a", 6) != 0))
+            throw GifDecoderError(fmt::format("Not a GIF file: {}", path.string()));
+
+        mOffset = 6;
+        int width = word();
+        int height = word();
+        auto flags = byte();
+        byte();     // Background color index, the background is disposed to transparent as browsers do.
+        byte();     // Pixel aspect ratio.
+        if (width == 0 || height == 0)
+            throw GifDecoderError(fmt::format("Empty GIF logical screen: {}", path.string()));
+        mSize = Size{width, height};
+
+        if (flags & 0x80u) {
+            auto tableSize = std::size_t{3} << ((flags & 0x07u) + 1);
+            if (mOffset + tableSize > mData.size())
+                throw GifDecoderError(fmt::format("Truncated GIF file: {}", path.string()));
+            readPalette(mData.subspan(mOffset, tableSize), mGlobalPalette);
+            mOffset += tableSize;
+        }
+        mFirstBlock = mOffset;
+        rewind();
+    }
+
+    uint8_t GifDecoder::byte() {
+        if (mOffset >= mData.size())
+            throw GifDecoderError("Truncated GIF file");
+        return mData[mOffset++];
+    }
+
+    uint16_t GifDecoder::word() {
+        auto low = byte();
+        return static_cast<uint16_t>(low | byte() << 8u);
+    }
+
+    void GifDecoder::skipSubBlocks() {
+        for (auto length = byte(); length != 0; length = byte()) {
+            if (mOffset + length > mData.size())
+                throw GifDecoderError("Truncated GIF file");
+            mOffset += length;
+        }
+    }
+
+    void GifDecoder::extension() {
+        auto label = byte();
+        if (label == GraphicControlLabel) {
+            auto length = byte();
+            if (length >= 4 && mOffset + length <= mData.size()) {
+                auto flags = byte();
+                mDisposal = (flags >> 2u) & 0x07;
+                auto delay = static_cast<uint32_t>(word()) * 10;
+                mDelay = delay < MinimumDelay ? DefaultDelay : delay;
+                auto transparent = byte();
+                mTransparent = (flags & 0x01u) ? transparent : -1;
+                mOffset += length - 4u;
+            } else {
+                mOffset += length;
+            }
+        } else if (label == ApplicationLabel) {
+            auto length = byte();
+            if (length == 11 && mOffset + 11 <= mData.size() &&
+                (std::memcmp(mData.data() + mOffset, "NETSCAPE2.0", 11) == 0 ||
+                 std::memcmp(mData.data() + mOffset, "ANIMEXTS1.0", 11) == 0)) {
+                mOffset += 11;
+                if (auto blockLength = byte(); blockLength >= 3) {
+                    auto id = byte();
+                    auto count = word();
+                    if (id == 1)
+                        mLoopCount = count;
+                    mOffset += blockLength - 3u;
+                } else {
+                    mOffset += blockLength;
+                }
+            } else {
+                mOffset += length;
+            }
+        }
+        skipSubBlocks();
+    }
+
+    void GifDecoder::decompress(int minimumCodeSize) {
+        if (minimumCodeSize < 2 || minimumCodeSize > 11)
+            throw GifDecoderError(fmt::format("Bad GIF LZW code size: {}", minimumCodeSize));
+
+        const int clear = 1 << minimumCodeSize;
+        const int end = clear + 1;
+        for (int code = 0; code < clear; ++code) {
+            mPrefix[static_cast<std::size_t>(code)] = 0;
+            mSuffix[static_cast<std::size_t>(code)] = static_cast<uint8_t>(code);
+        }
+
+        int codeSize = minimumCodeSize + 1;
+        int next = clear + 2;
+        int previous = -1;
+        uint8_t first{};
+        uint32_t bits{};
+        int bitCount{};
+        std::size_t blockRemaining{};
+        std::size_t out{};
+        bool dataEnded{false};
+
+        while (out < mIndices.size()) {
+            while (bitCount < codeSize) {
+                if (blockRemaining == 0) {
+                    blockRemaining = byte();
+                    if (blockRemaining == 0) {
+                        dataEnded = true;
+                        break;
+                    }
+                }
+                bits |= static_cast<uint32_t>(byte()) << static_cast<uint32_t>(bitCount);
+                bitCount += 8;
+                --blockRemaining;
+            }
+            if (dataEnded)
+                break;
+
+            auto code = static_cast<int>(bits & ((1u << static_cast<uint32_t>(codeSize)) - 1u));
+            bits >>= static_cast<uint32_t>(codeSize);
+            bitCount -= codeSize;
+
+            if (code == clear) {
+                codeSize = minimumCodeSize + 1;
+                next = clear + 2;
+                previous = -1;
+                continue;
+            }
+            if (code == end)
+                break;
+
+            if (previous < 0) {
+                if (code >= clear)
+                    throw GifDecoderError("Bad GIF LZW code");
+                first = static_cast<uint8_t>(code);
+                mIndices[out++] = first;
+                previous = code;
+                continue;
+            }
+
+            auto current = code;
+            std::size_t depth = 0;
+            if (code >= next) {
+                if (code > next)
+                    throw GifDecoderError("Bad GIF LZW code");
+                mStack[depth++] = first;
+                code = previous;
+            }
+            while (code >= clear) {
+                if (depth >= static_cast<std::size_t>(MaxCodes))
+                    throw GifDecoderError("Bad GIF LZW string");
+                mStack[depth++] = mSuffix[static_cast<std::size_t>(code)];
+                code = mPrefix[static_cast<std::size_t>(code)];
+            }
+            first = static_cast<uint8_t>(code);
+            mStack[depth++] = first;
+
+            if (next < MaxCodes) {
+                mPrefix[static_cast<std::size_t>(next)] = static_cast<uint16_t>(previous);
+                mSuffix[static_cast<std::size_t>(next)] = first;
+                ++next;
+                if (next == 1 << codeSize && codeSize < 12)
+                    ++codeSize;
+            }
+
+            while (depth > 0 && out < mIndices.size())
+                mIndices[out++] = mStack[--depth];
+            previous = current;
+        }
+
+        // Skip whatever remains of the image data, including the terminator.
+        if (!dataEnded) {
+            mOffset += blockRemaining;
+            skipSubBlocks();
+        }
+    }
+
+    GifDecoder::Frame GifDecoder::image() {
+        int left = word();
+        int top = word();
+        int width = word();
+        int height = word();
+        auto flags = byte();
+
+        std::array<uint32_t, 256> localPalette{};
+        const std::array<uint32_t, 256> *palette = &mGlobalPalette;
+        if (flags & 0x80u) {
+            auto tableSize = std::size_t{3} << ((flags & 0x07u) + 1);
+            if (mOffset + tableSize > mData.size())
+                throw GifDecoderError("Truncated GIF file");
+            readPalette(mData.subspan(mOffset, tableSize), localPalette);
+            mOffset += tableSize;
+            palette = &localPalette;
+        }
+
+        mIndices.assign(static_cast<std::size_t>(width) * static_cast<std::size_t>(height),
+                        static_cast<uint8_t>(mTransparent < 0 ? 0 : mTransparent));
+        decompress(byte());
+
+        // Dispose of the last frame, then save the canvas if this frame restores to previous.
+        auto screenWidth = static_cast<std::size_t>(mSize.w);
+        if (mLastDisposal == DisposeBackground) {
+            for (int y = mLastRect.y; y < mLastRect.y + mLastRect.h; ++y) {
+                auto row = mCanvas.begin() + static_cast<std::ptrdiff_t>(static_cast<std::size_t>(y) * screenWidth);
+                std::fill(row + mLastRect.x, row + mLastRect.x + mLastRect.w, 0u);
+            }
+        } else if (mLastDisposal == DisposePrevious && mPrevious.size() == mCanvas.size()) {
+            mCanvas = mPrevious;
+        }
+        if (mDisposal == DisposePrevious)
+            mPrevious = mCanvas;
+
+        // The part of the frame on the logical screen.
+        SDL_Rect area{std::min(left, mSize.w), std::min(top, mSize.h), 0, 0};
+        area.w = std::min(width, mSize.w - area.x);
+        area.h = std::min(height, mSize.h - area.y);
+
+        auto rows = rowOrder(height, flags & 0x40u);
+        for (int i = 0; i < height; ++i) {
+            auto y = rows[static_cast<std::size_t>(i)];
+            if (y >= area.h)
+                continue;
+            auto source = mIndices.data() + static_cast<std::size_t>(i) * static_cast<std::size_t>(width);
+            auto target = mCanvas.data() + static_cast<std::size_t>(area.y + y) * screenWidth +
+                          static_cast<std::size_t>(area.x);
+            for (int x = 0; x < area.w; ++x) {
+                auto index = source[x];
+                if (index != mTransparent)
+                    target[x] = (*palette)[index];
+            }
+        }
+
+        mLastDisposal = mDisposal;
+        mLastRect = area;
+
+        Frame frame{};
+        frame.delay = mDelay;
+        frame.image.reset(SDL_CreateRGBSurfaceWithFormat(0, mSize.w, mSize.h, 32, SDL_PIXELFORMAT_ARGB8888));
+        if (!frame.image)
+            throw GifDecoderError(fmt::format("Can not create frame surface: {}", SDL_GetError()));
+        for (int y = 0; y < mSize.h; ++y)
+            std::memcpy(static_cast<uint8_t *>(frame.image->pixels) + static_cast<std::ptrdiff_t>(y) * frame.image->pitch,
+                        mCanvas.data() + static_cast<std::size_t>(y) * screenWidth, screenWidth * sizeof(uint32_t));
+
+        // The graphic control extension applies to one image.
+        mDisposal = 0;
+        mTransparent = -1;
+        mDelay = DefaultDelay;
+        return frame;
+    }
+
+    std::optional<GifDecoder::Frame> GifDecoder::next() {
+        while (true) {
+            auto introducer = mOffset < mData.size() ? mData[mOffset++] : Trailer;
+            switch (introducer) {
+                case ImageSeparator:
+                    mFramesThisLoop = true;
+                    return image();
+                case ExtensionIntroducer:
+                    extension();
+                    break;
+                case Trailer: {
+                    ++mLoopsDone;
+                    bool repeat = mFramesThisLoop && (mLoopCount == 0 || mLoopsDone <= mLoopCount);
+                    if (!repeat)
+                        return std::nullopt;
+                    auto loopsDone = mLoopsDone;
+                    rewind();
+                    mLoopsDone = loopsDone;
+                    break;
+                }
+                default:
+                    throw GifDecoderError(fmt::format("Bad GIF block: {:#x}", introducer));
+            }
+        }
+    }
+
+    void GifDecoder::rewind() {
+        mOffset = mFirstBlock;
+        mCanvas.assign(static_cast<std::size_t>(mSize.w) * static_cast<std::size_t>(mSize.h), 0u);
+        mPrevious.clear();
+        mLoopsDone = 0;
+        mFramesThisLoop = false;
+        mDisposal = 0;
+        mTransparent = -1;
+        mDelay = DefaultDelay;
+        mLastDisposal = 0;
+        mLastRect = SDL_Rect{};
+    }
+
+} // rose
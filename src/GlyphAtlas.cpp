@@ -0,0 +1,96 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * GlyphAtlas.cpp Created by Richard Buckley (C) 18/10/26
+ */
+
+#include "GlyphAtlas.h"
+#include "Surface.h"
+#include <algorithm>
+
+namespace rose {
+
+    GlyphAtlas::GlyphAtlas(FontPointer font) : mFont(std::move(font)) {
+        auto height = mFont ? TTF_FontHeight(mFont.get()) : 0;
+        mPageSize = MinimumPageSize;
+        while (mPageSize < MaximumPageSize && mPageSize < height * 8)
+            mPageSize *= 2;
+    }
+
+    void GlyphAtlas::addPage(Context &context) {
+        Texture page{context, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, mPageSize, mPageSize};
+        std::vector<uint32_t> clear(static_cast<std::size_t>(mPageSize) * static_cast<std::size_t>(mPageSize), 0u);
+        SDL_UpdateTexture(page.get(), nullptr, clear.data(), mPageSize * static_cast<int>(sizeof(uint32_t)));
+        page.setBlendMode(SDL_BLENDMODE_BLEND);
+        // Linear filtering is exact at 1:1 and lets glyphs be drawn scaled, the gutter keeps neighbours apart.
+        SDL_SetTextureScaleMode(page.get(), SDL_ScaleModeLinear);
+        mPages.push_back(std::move(page));
+        mCursor = Point{Gutter, Gutter};
+        mShelfHeight = 0;
+    }
+
+    std::optional<AtlasGlyph> GlyphAtlas::allocate(Context &context, Size size) {
+        if (size.w + 2 * Gutter > mPageSize || size.h + 2 * Gutter > mPageSize)
+            return std::nullopt;
+
+        if (mPages.empty())
+            addPage(context);
+
+        if (mCursor.x + size.w + Gutter > mPageSize) {
+            mCursor = Point{Gutter, mCursor.y + mShelfHeight + Gutter};
+            mShelfHeight = 0;
+        }
+
+        if (mCursor.y + size.h + Gutter > mPageSize)
+            addPage(context);
+
+        AtlasGlyph glyph{mPages.size() - 1, Rectangle{mCursor.x, mCursor.y, size.w, size.h}};
+        mCursor.x += size.w + Gutter;
+        mShelfHeight = std::max(mShelfHeight, size.h);
+        return glyph;
+    }
+
+    std::optional<AtlasGlyph> GlyphAtlas::rasterize(Context &context, uint32_t code) {
+        if (!mFont)
+            return std::nullopt;
+
+        Surface surface{TTF_RenderGlyph32_Blended(mFont.get(), code, color::OpaqueWhite.sdlColor())};
+        if (!surface || surface->w == 0 || surface->h == 0)
+            return std::nullopt;
+
+        if (surface->format->format != SDL_PIXELFORMAT_ARGB8888) {
+            surface.reset(SDL_ConvertSurfaceFormat(surface.get(), SDL_PIXELFORMAT_ARGB8888, 0));
+            if (!surface)
+                return std::nullopt;
+        }
+
+        auto glyph = allocate(context, Size{surface->w, surface->h});
+        if (glyph) {
+            SDL_Rect rect{glyph->rect.point.x, glyph->rect.point.y, glyph->rect.size.w, glyph->rect.size.h};
+            SurfaceLock lock{surface.get()};
+            SDL_UpdateTexture(mPages[glyph->page].get(), &rect, surface->pixels, surface->pitch);
+        }
+        return glyph;
+    }
+
+    const AtlasGlyph *GlyphAtlas::glyph(Context &context, uint32_t code) {
+        auto found = mGlyphs.find(code);
+        if (found == mGlyphs.end())
+            found = mGlyphs.emplace(code, rasterize(context, code)).first;
+        return found->second ? &found->second.value() : nullptr;
+    }
+
+    void GlyphAtlas::preload(Context &context, std::u32string_view codes) {
+        for (auto code : codes)
+            glyph(context, static_cast<uint32_t>(code));
+    }
+
+    void GlyphAtlas::render(Context &context, const AtlasGlyph &glyph, const Rectangle &dst, const Color &color) {
+        auto &page = mPages[glyph.page];
+        page.setColorMod(color);
+        context.renderCopy(page, glyph.rect, dst);
+    }
+
+} // rose
@@ -107,6 +107,18 @@ namespace rose {
             throw ContextException(fmt::format("{}: {}", __FUNCTION__, SDL_GetError()));
     }
 
+    bool Context::isVisible(const Rectangle &rect) const {
+        SDL_Rect area{};
+        SDL_RenderGetClipRect(get(), &area);
+        if (SDL_RectEmpty(&area)) {
+            area.x = area.y = 0;
+            if (SDL_GetRendererOutputSize(get(), &area.w, &area.h))
+                return true;
+        }
+        SDL_Rect sdlRect{rect.point.x, rect.point.y, rect.size.w, rect.size.h};
+        return SDL_HasIntersection(&area, &sdlRect) == SDL_TRUE;
+    }
+
     [[maybe_unused]] void Context::drawPoint(const Point &p) const {
         if (SDL_RenderDrawPoint(get(), p.x, p.y))
             throw ContextException(fmt::format("{}: {}", __FUNCTION__, SDL_GetError()));
@@ -154,6 +166,13 @@ namespace rose {
         return SDL_SetTextureAlphaMod(get(), alphaMod);
     }
 
+    int Texture::setColorMod(const Color &color) {
+        auto sdlColor = color.sdlColor();
+        if (auto status = SDL_SetTextureColorMod(get(), sdlColor.r, sdlColor.g, sdlColor.b); status)
+            return status;
+        return SDL_SetTextureAlphaMod(get(), sdlColor.a);
+    }
+
     /**
      * GraphicsModel
      */
@@ -0,0 +1,83 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * IconSheet.cpp Created by Richard Buckley (C) 18/10/26
+ */
+
+#include "IconSheet.h"
+#include <algorithm>
+#include <fstream>
+
+namespace rose {
+
+    IconSheet::IconSheet(const std::filesystem::path &basePath) : mName(basePath.string()) {
+        auto tablePath = basePath;
+        tablePath.replace_extension("bin");
+        std::ifstream strm{tablePath, std::ios::binary};
+        if (!strm)
+            throw IconSheetException(fmt::format("Can not open icon sheet table '{}'", tablePath.string()));
+
+        Header header{};
+        if (!strm.read(reinterpret_cast<char *>(&header), sizeof(header)) || header.magic != Magic ||
+            header.version != Version)
+            throw IconSheetException(fmt::format("Not an icon sheet table '{}'", tablePath.string()));
+
+        // The count is checked against the file before it is trusted with an allocation.
+        std::error_code ec{};
+        auto fileSize = std::filesystem::file_size(tablePath, ec);
+        if (ec || fileSize < sizeof(header) || header.count > (fileSize - sizeof(header)) / sizeof(Entry))
+            throw IconSheetException(fmt::format("Short icon sheet table '{}'", tablePath.string()));
+
+        mPointSize = static_cast<int>(header.pointSize);
+        mEntries.resize(header.count);
+        if (!strm.read(reinterpret_cast<char *>(mEntries.data()),
+                       static_cast<std::streamsize>(mEntries.size() * sizeof(Entry))))
+            throw IconSheetException(fmt::format("Short icon sheet table '{}'", tablePath.string()));
+        std::sort(mEntries.begin(), mEntries.end(), [](const Entry &a, const Entry &b) { return a.code < b.code; });
+
+        auto imagePath = basePath;
+        imagePath.replace_extension("png");
+        try {
+            mSheet = Surface{imagePath};
+        } catch (const SurfaceRuntimeError &e) {
+            throw IconSheetException(e.what());
+        }
+
+        for (const auto &entry : mEntries) {
+            if (entry.x + entry.w > mSheet->w || entry.y + entry.h > mSheet->h)
+                throw IconSheetException(fmt::format("Icon {:#x} is outside the sheet '{}'", entry.code,
+                                                     imagePath.string()));
+        }
+    }
+
+    const IconSheet::Entry *IconSheet::find(uint32_t code) const {
+        auto found = std::lower_bound(mEntries.begin(), mEntries.end(), code,
+                                      [](const Entry &entry, uint32_t c) { return entry.code < c; });
+        if (found != mEntries.end() && found->code == code)
+            return &(*found);
+        return nullptr;
+    }
+
+    void IconSheet::render(Context &context, Texture &sheet, const Entry &entry, Point point, const Color &color) {
+        sheet.setColorMod(color);
+        context.renderCopy(sheet, Rectangle{entry.x, entry.y, entry.w, entry.h},
+                           Rectangle{point.x, point.y, entry.w, entry.h});
+    }
+
+    void IconSheet::writeTable(const std::filesystem::path &path, int pointSize, std::vector<Entry> entries) {
+        std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) { return a.code < b.code; });
+
+        std::ofstream strm{path, std::ios::binary | std::ios::trunc};
+        Header header{};
+        header.pointSize = static_cast<uint32_t>(pointSize);
+        header.count = static_cast<uint32_t>(entries.size());
+        strm.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        strm.write(reinterpret_cast<const char *>(entries.data()),
+                   static_cast<std::streamsize>(entries.size() * sizeof(Entry)));
+        if (!strm)
+            throw IconSheetException(fmt::format("Can not write icon sheet table '{}'", path.string()));
+    }
+
+} // rose
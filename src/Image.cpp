@@ -14,35 +14,187 @@
  */
 
 #include "Image.h"
+#include <Application.h>
+#include <ImageDecode.h>
 #include <Surface.h>
 
 namespace rose {
     void Image::createTexture(Context &context) {
+        mDecodeRequested = true;
         if (!mImageFilePath.empty() && exists(mImageFilePath)) {
-            Surface image{mImageFilePath};
+            Surface image{decodeImage(mImageFilePath, mLevelSize)};
             if (image) {
-                image.textureFromSurface(context, mTexture);
-                mVisualMetrics.desiredSize = mTexture.getSize();
+                mTexture = std::make_shared<Texture>(image.toTexture(context));
+                if (!mNaturalSize)
+                    mVisualMetrics.desiredSize = mTexture->getSize();
             }
         }
     }
 
-    void Image::draw(Context &context, Point drawLocation) {
-        Gadget::draw(context, drawLocation);
-        if (mTexture) {
-            context.renderCopy(mTexture, mVisualMetrics.renderRect + drawLocation);
+    void Image::requestDecode(Context &context) {
+        mDecodeRequested = true;
+        auto application = getApplicationPtr();
+        // The natural size is cached with an unset Size, the same entry whatever size it is drawn at.
+        auto key = ImageKey::make(mImageFilePath, mLevelSize == mNaturalSize ? Size{} : mLevelSize);
+        if (!application || !key) {
+            createTexture(context);
+            return;
         }
+
+        // A decode still in flight for another level is stale, even if this one is already cached.
+        auto generation = ++mDecodeGeneration;
+        auto &cache = application->imageCache();
+        if (auto texture = cache.findTexture(context.get(), key.value()); texture) {
+            textureReady(texture);
+            return;
+        }
+
+        // Pixels decoded on an earlier run are mapped from the PixelStore, the file is decoded only if they are not.
+        std::weak_ptr<Gadget> weak = shared_from_this();
+        auto format = PixelStore::nativeFormat(context.get());
+        application->workerPool().submit([weak, &store = cache.pixelStore(), key = key.value(), format, generation]()
+                -> WorkerPool::Completion {
+            auto stored = std::make_shared<std::optional<StoredImage>>(store.load(key, format));
+            return [weak, key, format, stored, generation]() {
+                if (auto image = std::dynamic_pointer_cast<Image>(weak.lock()); image)
+                    image->storeReady(key, format, *stored, generation);
+            };
+        });
     }
 
-    bool Image::initialLayout(Context &context) {
-        if (!mTexture) {
+    void Image::storeReady(const ImageKey &key, uint32_t format, const std::optional<StoredImage> &stored,
+                           uint64_t generation) {
+        auto window = getWindow();
+        auto application = getApplicationPtr();
+        if (!window || !application || generation != mDecodeGeneration)
+            return;
+
+        auto &cache = application->imageCache();
+        auto &context = window->context();
+        if (stored) {
+            auto texture = cache.findTexture(context.get(), key);
+            if (!texture) {
+                if (auto uploaded = PixelStore::upload(context, stored.value()); uploaded)
+                    texture = cache.insertTexture(context.get(), key, std::move(uploaded));
+            }
+            if (texture) {
+                textureReady(texture);
+                return;
+            }
+        }
+
+        std::weak_ptr<Gadget> weak = shared_from_this();
+        cache.requestSurface(key, application->workerPool(),
+                             [weak, key, generation](const ImageCache::SharedSurface &surface) {
+                                 if (auto image = std::dynamic_pointer_cast<Image>(weak.lock()); image)
+                                     image->imageReady(key, surface, generation);
+                             }, format);
+    }
+
+    void Image::textureReady(const SharedTexture &texture) {
+        mTexture = texture;
+        if (!mNaturalSize) {
+            mNaturalSize = mTexture->getSize();
+            if (!mDeclaredSize)
+                setNeedsLayout();
+        }
+        setNeedsDrawing();
+    }
+
+    void Image::imageReady(const ImageKey &key, const ImageCache::SharedSurface &surface, uint64_t generation) {
+        auto window = getWindow();
+        auto application = getApplicationPtr();
+        if (!surface || !*surface || !window || !application || generation != mDecodeGeneration)
+            return;
+
+        auto &cache = application->imageCache();
+        auto &context = window->context();
+        try {
+            auto texture = cache.findTexture(context.get(), key);
+            if (!texture)
+                texture = cache.insertTexture(context.get(), key, surface->toTexture(context));
+            textureReady(texture);
+        } catch (const SurfaceRuntimeError &e) {
+            fmt::print("{}\n", e.what());
+        }
+    }
+
+    void Image::startWatch() {
+        auto application = getApplicationPtr();
+        if (!application)
+            return;
+
+        std::weak_ptr<Gadget> weak = shared_from_this();
+        try {
+            // The header is read on the WorkerPool, the decode is requested on the UI thread in the usual way.
+            mWatch = application->fileWatcher().watch(mImageFilePath, [weak, path = mImageFilePath]()
+                    -> WorkerPool::Completion {
+                auto size = imageFileSize(path).value_or(Size{});
+                return [weak, size]() {
+                    if (auto image = std::dynamic_pointer_cast<Image>(weak.lock()); image)
+                        image->fileChanged(size);
+                };
+            });
+        } catch (const FileWatcherError &e) {
+            fmt::print("{}\n", e.what());
+            mWatchFile = false;
+        }
+    }
+
+    void Image::fileChanged(Size naturalSize) {
+        auto window = getWindow();
+        if (!window)
+            return;
+
+        if (naturalSize != mNaturalSize) {
+            mNaturalSize = naturalSize;
+            if (!mDeclaredSize)
+                setNeedsLayout();
+        }
+        mLevelSize = mipLevelSize(mNaturalSize, mVisualMetrics.renderRect.size);
+        requestDecode(window->context());
+    }
+
+    void Image::draw(Context &context, Point drawLocation) {
+        Gadget::draw(context, drawLocation);
+        auto renderRect = mVisualMetrics.renderRect + drawLocation;
+        if (mWatchFile && !mWatch && !mImageFilePath.empty())
+            startWatch();
+
+        auto level = mipLevelSize(mNaturalSize, renderRect.size);
+        // Without a size from the header the layout is empty and never visible, so decode to find the size.
+        if ((!mDecodeRequested || level != mLevelSize) && !mImageFilePath.empty() &&
+            (context.isVisible(renderRect) || !mNaturalSize)) {
             try {
-                createTexture(context);
-                mVisualMetrics.desiredSize = mTexture.getSize();
+                // The current Texture is drawn, scaled, until the new level arrives.
+                mLevelSize = level;
+                requestDecode(context);
             } catch (std::exception &e) {
                 fmt::print("{}\n", e.what());
             }
         }
+
+        if (mTexture) {
+            context.renderCopy(*mTexture, renderRect);
+        } else if (mPlaceholderColor) {
+            context.fillRect(renderRect, mPlaceholderColor);
+        }
+    }
+
+    bool Image::initialLayout(Context &context) {
+        if (!mNaturalSize && !mImageFilePath.empty()) {
+            // Only the header is read, the pixels are decoded when the gadget is first drawn.
+            mNaturalSize = imageFileSize(mImageFilePath).value_or(Size{});
+        }
+
+        if (mDeclaredSize) {
+            mImageSize = mDeclaredSize;
+        } else if (mNaturalSize) {
+            mImageSize = mNaturalSize;
+        } else if (mTexture) {
+            mImageSize = mTexture->getSize();
+        }
+        mVisualMetrics.desiredSize = mImageSize;
         return Gadget::initialLayout(context);
     }
-} // rose
\ No newline at end of file
+} // rose
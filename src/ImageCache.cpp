@@ -0,0 +1,115 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * ImageCache.cpp Created by Richard Buckley (C) 18/10/26
+ */
+
+#include "ImageCache.h"
+#include "ImageDecode.h"
+
+namespace rose {
+
+    namespace {
+        std::size_t combine(std::size_t seed, std::size_t value) {
+            return seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6u) + (seed >> 2u));
+        }
+    }
+
+    std::optional<ImageKey> ImageKey::make(const std::filesystem::path &path, Size size) {
+        std::error_code ec{};
+        auto modified = std::filesystem::last_write_time(path, ec);
+        if (ec)
+            return std::nullopt;
+        auto fileSize = std::filesystem::file_size(path, ec);
+        if (ec)
+            return std::nullopt;
+        return ImageKey{path.string(), static_cast<int64_t>(modified.time_since_epoch().count()), fileSize,
+                        size ? size.w : 0, size ? size.h : 0};
+    }
+
+    std::size_t ImageKeyHash::operator()(const ImageKey &key) const noexcept {
+        auto seed = std::hash<std::string>{}(key.path);
+        seed = combine(seed, std::hash<int64_t>{}(key.modified));
+        seed = combine(seed, std::hash<uintmax_t>{}(key.fileSize));
+        seed = combine(seed, std::hash<int>{}(key.width));
+        return combine(seed, std::hash<int>{}(key.height));
+    }
+
+    std::size_t ImageTextureKeyHash::operator()(const ImageTextureKey &key) const noexcept {
+        return combine(ImageKeyHash{}(key.image), std::hash<const void *>{}(key.renderer));
+    }
+
+    SharedTexture ImageCache::insertTexture(SDL_Renderer *renderer, const ImageKey &key, Texture &&texture) {
+        auto size = texture.getSize();
+        auto cost = static_cast<std::size_t>(size.w) * static_cast<std::size_t>(size.h) * 4;
+        return mTextures.insert(ImageTextureKey{renderer, key}, std::make_shared<Texture>(std::move(texture)), cost);
+    }
+
+    ImageCache::SharedSurface ImageCache::insertSurface(const ImageKey &key, Surface &&surface) {
+        auto cost = surface ? static_cast<std::size_t>(surface->pitch) * static_cast<std::size_t>(surface->h) : 0;
+        return mSurfaces.insert(key, std::make_shared<Surface>(std::move(surface)), cost);
+    }
+
+    void ImageCache::requestSurface(const ImageKey &key, WorkerPool &workerPool, SurfaceCallback callback,
+                                    uint32_t storeFormat) {
+        if (auto surface = findSurface(key); surface) {
+            callback(surface);
+            return;
+        }
+
+        auto &waiting = mPending[key];
+        waiting.push_back(std::move(callback));
+        if (waiting.size() > 1)
+            return;
+
+        ++mDecodes;
+        workerPool.submit([this, key, storeFormat]() -> WorkerPool::Completion {
+            auto surface = std::make_shared<Surface>(decodeImage(key.path, key.size()));
+            if (!*surface)
+                fmt::print("Image decode error: {} -- {}\n", key.path, SDL_GetError());
+            else if (storeFormat != SDL_PIXELFORMAT_UNKNOWN)
+                mPixelStore.save(key, *surface, storeFormat);    // While this job is the only user of the Surface.
+            return [this, key, surface]() {
+                SharedSurface shared{};
+                if (*surface)
+                    shared = insertSurface(key, std::move(*surface));
+
+                auto found = mPending.find(key);
+                if (found == mPending.end())
+                    return;
+                auto callbacks = std::move(found->second);
+                mPending.erase(found);
+                for (auto &waiting : callbacks)
+                    waiting(shared);
+            };
+        });
+    }
+
+    void ImageCache::purgeRenderer(SDL_Renderer *renderer) {
+        mTextures.eraseIf([renderer](const ImageTextureKey &key, const SharedTexture &) {
+            return key.renderer == renderer;
+        });
+    }
+
+    ImageCacheStatistics ImageCache::statistics() const {
+        ImageCacheStatistics statistics{};
+        statistics.surfaceHits = mSurfaces.hits();
+        statistics.surfaceMisses = mSurfaces.misses();
+        statistics.textureHits = mTextures.hits();
+        statistics.textureMisses = mTextures.misses();
+        statistics.evictions = mSurfaces.evictions() + mTextures.evictions();
+        statistics.decodes = mDecodes;
+        statistics.surfaceBytes = mSurfaces.cost();
+        statistics.textureBytes = mTextures.cost();
+        return statistics;
+    }
+
+    void ImageCache::resetStatistics() {
+        mSurfaces.resetStatistics();
+        mTextures.resetStatistics();
+        mDecodes = 0;
+    }
+
+} // rose
@@ -0,0 +1,205 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * ImageDecode.cpp Created by Richard Buckley (C) 18/10/26
+ */
+
+#include "ImageDecode.h"
+#include <SDL_image.h>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace rose {
+
+    namespace {
+        uint32_t bigEndian16(std::span<const uint8_t> b, std::size_t at) {
+            return static_cast<uint32_t>(b[at]) << 8u | b[at + 1];
+        }
+
+        uint32_t bigEndian32(std::span<const uint8_t> b, std::size_t at) {
+            return bigEndian16(b, at) << 16u | bigEndian16(b, at + 2);
+        }
+
+        uint32_t littleEndian16(std::span<const uint8_t> b, std::size_t at) {
+            return static_cast<uint32_t>(b[at + 1]) << 8u | b[at];
+        }
+
+        uint32_t littleEndian32(std::span<const uint8_t> b, std::size_t at) {
+            return littleEndian16(b, at + 2) << 16u | littleEndian16(b, at);
+        }
+
+        bool startsWith(std::span<const uint8_t> b, std::string_view magic) {
+            return b.size() >= magic.size() && std::memcmp(b.data(), magic.data(), magic.size()) == 0;
+        }
+
+        std::optional<Size> makeSize(uint32_t w, uint32_t h) {
+            if (w == 0 || h == 0 || w > 0xFFFFu || h > 0xFFFFu)
+                return std::nullopt;
+            return Size{static_cast<int>(w), static_cast<int>(h)};
+        }
+
+        /**
+         * @brief Scan JPEG markers for the first start of frame.
+         */
+        std::optional<Size> jpegSize(std::span<const uint8_t> b) {
+            std::size_t at = 2;
+            while (at + 4 <= b.size()) {
+                if (b[at] != 0xFF)
+                    return std::nullopt;
+                auto marker = b[at + 1];
+                if (marker == 0xFF) {               // Fill byte.
+                    ++at;
+                    continue;
+                }
+                if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD9)) {     // Markers without a segment.
+                    at += 2;
+                    continue;
+                }
+
+                auto length = bigEndian16(b, at + 2);
+                bool startOfFrame = marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 &&
+                                    marker != 0xCC;
+                if (startOfFrame) {
+                    if (at + 9 > b.size())
+                        return std::nullopt;
+                    return makeSize(bigEndian16(b, at + 7), bigEndian16(b, at + 5));
+                }
+                at += 2 + length;
+            }
+            return std::nullopt;
+        }
+    }
+
+    std::optional<Size> imageHeaderSize(std::span<const uint8_t> header) {
+        if (startsWith(header, "\x89PNG\r\n\x1a\n")) {
+            if (header.size() >= 24 && std::memcmp(header.data() + 12, "IHDR", 4) == 0)
+                return makeSize(bigEndian32(header, 16), bigEndian32(header, 20));
+        } else if (startsWith(header, "GIF87a") || startsWith(header, "GIF89a")) {
+            if (header.size() >= 10)
+                return makeSize(littleEndian16(header, 6), littleEndian16(header, 8));
+        } else if (startsWith(header, "\xFF\xD8")) {
+            return jpegSize(header);
+        } else if (startsWith(header, "BM")) {
+            if (header.size() >= 26) {
+                // A negative height marks a top down bitmap, negated unsigned so INT32_MIN is rejected as too big.
+                auto h = littleEndian32(header, 22);
+                return makeSize(littleEndian32(header, 18), static_cast<int32_t>(h) < 0 ? 0u - h : h);
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::optional<Size> imageFileSize(const std::filesystem::path &path) {
+        // JPEG files may carry large EXIF segments before the frame header, so read more if needed.
+        static constexpr std::array<std::size_t, 2> ReadSizes{4096, 262144};
+
+        std::ifstream strm{path, std::ios::binary};
+        if (!strm)
+            return std::nullopt;
+
+        std::vector<uint8_t> header{};
+        for (auto readSize : ReadSizes) {
+            auto have = header.size();
+            header.resize(readSize);
+            strm.read(reinterpret_cast<char *>(header.data() + have), static_cast<std::streamsize>(readSize - have));
+            header.resize(have + static_cast<std::size_t>(strm.gcount()));
+            if (auto size = imageHeaderSize(header); size || !strm)
+                return size;
+        }
+        return std::nullopt;
+    }
+
+    Size mipLevelSize(Size natural, Size target) {
+        if (!natural || !target)
+            return natural;
+        auto level = natural;
+        while (level.w / 2 >= std::max(target.w, 1) && level.h / 2 >= std::max(target.h, 1)) {
+            level.w /= 2;
+            level.h /= 2;
+        }
+        return level;
+    }
+
+    Surface halveImage(const Surface &image) {
+        if (!image)
+            return Surface{};
+
+        Surface converted{};
+        SDL_Surface *source = image.get();
+        if (source->format->BytesPerPixel != 4) {
+            converted.reset(SDL_ConvertSurfaceFormat(source, SDL_PIXELFORMAT_ARGB8888, 0));
+            if (!converted)
+                return Surface{};
+            source = converted.get();
+        }
+
+        auto width = std::max(source->w / 2, 1);
+        auto height = std::max(source->h / 2, 1);
+        Surface level{SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, source->format->format)};
+        if (!level)
+            return Surface{};
+
+        SurfaceLock sourceLock{source};
+        SurfaceLock levelLock{level.get()};
+        if (!sourceLock || !levelLock)
+            return Surface{};
+
+        auto row = [](SDL_Surface *surface, int y) {
+            return reinterpret_cast<uint32_t *>(static_cast<uint8_t *>(surface->pixels) +
+                                                static_cast<std::ptrdiff_t>(y) * surface->pitch);
+        };
+
+        // Two channels are summed in each half of a 32 bit word, four 8 bit values can not carry out of 16 bits.
+        static constexpr uint32_t Lanes = 0x00FF00FFu;
+        static constexpr uint32_t Round = 0x00020002u;
+        for (int y = 0; y < height; ++y) {
+            auto top = row(source, std::min(2 * y, source->h - 1));
+            auto bottom = row(source, std::min(2 * y + 1, source->h - 1));
+            auto out = row(level.get(), y);
+            for (int x = 0; x < width; ++x) {
+                auto x0 = std::min(2 * x, source->w - 1);
+                auto x1 = std::min(2 * x + 1, source->w - 1);
+                uint32_t p0 = top[x0], p1 = top[x1], p2 = bottom[x0], p3 = bottom[x1];
+                uint32_t even = (p0 & Lanes) + (p1 & Lanes) + (p2 & Lanes) + (p3 & Lanes) + Round;
+                uint32_t odd = ((p0 >> 8u) & Lanes) + ((p1 >> 8u) & Lanes) + ((p2 >> 8u) & Lanes) +
+                               ((p3 >> 8u) & Lanes) + Round;
+                out[x] = ((even >> 2u) & Lanes) | (((odd >> 2u) & Lanes) << 8u);
+            }
+        }
+        return level;
+    }
+
+    Surface downscaleImage(Surface image, Size size) {
+        if (!image || !size)
+            return image;
+
+        auto level = mipLevelSize(Size{image->w, image->h}, size);
+        while (image->w > level.w || image->h > level.h) {
+            auto half = halveImage(image);
+            if (!half)
+                return image;
+            image = std::move(half);
+        }
+
+        if ((image->w == size.w && image->h == size.h) || size.w > image->w || size.h > image->h)
+            return image;
+
+        Surface scaled{SDL_CreateRGBSurfaceWithFormat(0, size.w, size.h, 32, SDL_PIXELFORMAT_ARGB8888)};
+        if (!scaled)
+            return image;
+        SDL_SetSurfaceBlendMode(image.get(), SDL_BLENDMODE_NONE);
+        if (SDL_BlitScaled(image.get(), nullptr, scaled.get(), nullptr))
+            return image;
+        return scaled;
+    }
+
+    Surface decodeImage(const std::filesystem::path &path, Size size) {
+        return downscaleImage(Surface{IMG_Load(path.c_str())}, size);
+    }
+
+} // rose
@@ -0,0 +1,64 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * MappedFile.cpp Created by Richard Buckley (C) 18/10/26
+ */
+
+#include "MappedFile.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+#include <fmt/format.h>
+
+namespace rose {
+
+    MappedFile::MappedFile(const std::filesystem::path &path) {
+        auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            throw MappedFileError(fmt::format("Can not open '{}': {}", path.string(), std::strerror(errno)));
+
+        struct stat status{};
+        if (::fstat(fd, &status) != 0) {
+            auto error = errno;
+            ::close(fd);
+            throw MappedFileError(fmt::format("Can not stat '{}': {}", path.string(), std::strerror(error)));
+        }
+
+        if (status.st_size > 0) {
+            auto data = ::mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_SHARED, fd, 0);
+            if (data == MAP_FAILED) {
+                auto error = errno;
+                ::close(fd);
+                throw MappedFileError(fmt::format("Can not map '{}': {}", path.string(), std::strerror(error)));
+            }
+            mData = data;
+            mSize = static_cast<std::size_t>(status.st_size);
+        }
+        ::close(fd);
+    }
+
+    MappedFile::MappedFile(MappedFile &&other) noexcept
+            : mData(std::exchange(other.mData, nullptr)), mSize(std::exchange(other.mSize, 0)) {}
+
+    MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+        if (this != &other) {
+            if (mData)
+                ::munmap(mData, mSize);
+            mData = std::exchange(other.mData, nullptr);
+            mSize = std::exchange(other.mSize, 0);
+        }
+        return *this;
+    }
+
+    MappedFile::~MappedFile() {
+        if (mData)
+            ::munmap(mData, mSize);
+    }
+
+} // rose
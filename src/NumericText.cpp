@@ -0,0 +1,93 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * NumericText.cpp Created by Richard Buckley (C) 18/10/26
+ */
+
+#include "NumericText.h"
+#include "manager/Window.h"
+#include <Application.h>
+
+namespace rose {
+
+    void NumericText::measureCells() {
+        if (!mFont) {
+            mFont = getFont(mFontName, mPointSize);
+        }
+
+        if (!mFont)
+            throw TextGadgetException( fmt::format("Font error"));
+
+        int width = 0;
+        for (auto code : mCharset)
+            width = std::max(width, getGlyphMetrics32(mFont, static_cast<Uint32>(code)).advance);
+        mCellSize = Size{width, TTF_FontHeight(mFont.get())};
+    }
+
+    bool NumericText::initialLayout(Context &context) {
+        mCells = utf32(mText);
+        try {
+            measureCells();
+            mVisualMetrics.desiredSize = Size{static_cast<int>(mCells.size()) * mCellSize.w, mCellSize.h};
+        } catch (TextGadgetException &e) {
+            fmt::print("{}\n", e.what());
+        }
+        return Gadget::initialLayout(context);
+    }
+
+    void NumericText::textChanged() {
+        auto cells = utf32(mText);
+        if (cells.size() != mCells.size() || !mVisualMetrics.lastDrawLocation) {
+            textUpdated();
+            return;
+        }
+
+        std::optional<std::size_t> first{}, last{};
+        for (std::size_t idx = 0; idx < cells.size(); ++idx) {
+            if (cells[idx] != mCells[idx]) {
+                if (!first)
+                    first = idx;
+                last = idx;
+            }
+        }
+        mCells = std::move(cells);
+
+        if (first) {
+            auto exposed = cellRectangle(first.value()) + mVisualMetrics.lastDrawLocation;
+            exposed.size.w = static_cast<int>(last.value() - first.value() + 1) * mCellSize.w;
+            if (auto window = getWindow(); window)
+                window->expose(exposed);
+            else
+                setNeedsDrawing();
+        }
+    }
+
+    void NumericText::draw(Context &context, Point drawLocation) {
+        Gadget::draw(context, drawLocation);
+        if (mCells.empty() || !mFont)
+            return;
+
+        if (!mAtlas || mAtlas->font() != mFont) {
+            if (auto cache = textureCache(); cache)
+                mAtlas = cache->glyphAtlas(context, mFontName, mPointSize, mFont);
+            else
+                mAtlas = std::make_shared<GlyphAtlas>(mFont);
+            mFont = mAtlas->font();
+            mAtlas->preload(context, mCharset);
+        }
+
+        for (std::size_t idx = 0; idx < mCells.size(); ++idx) {
+            auto cell = cellRectangle(idx) + drawLocation;
+            if (!context.isVisible(cell))
+                continue;
+            if (auto glyph = mAtlas->glyph(context, static_cast<uint32_t>(mCells[idx])); glyph) {
+                Rectangle dst{cell.point.x + (cell.size.w - glyph->rect.size.w) / 2, cell.point.y,
+                              glyph->rect.size.w, glyph->rect.size.h};
+                mAtlas->render(context, *glyph, dst, mTextFgColor);
+            }
+        }
+    }
+
+} // rose
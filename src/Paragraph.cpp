@@ -0,0 +1,259 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * Paragraph.cpp Created by Richard Buckley (C) 18/10/26
+ */
+
+#include "Paragraph.h"
+#include <algorithm>
+
+namespace rose {
+
+    void Paragraph::Line::shift(std::ptrdiff_t delta) {
+        auto move = [delta](std::size_t offset) {
+            return static_cast<std::size_t>(static_cast<std::ptrdiff_t>(offset) + delta);
+        };
+        begin = move(begin);
+        end = move(end);
+        next = move(next);
+        scanEnd = move(scanEnd);
+        shownEnd = move(shownEnd);
+        for (auto &stop : stops)
+            stop.first = move(stop.first);
+    }
+
+    int Paragraph::advance(char32_t code) const {
+        return getGlyphMetrics32(mFont, static_cast<Uint32>(code)).advance;
+    }
+
+    Paragraph::Line Paragraph::wrapLine(std::size_t begin) const {
+        Line line{};
+        line.begin = begin;
+
+        int width = 0;
+        bool content = false;               // A non-space character has been placed on the line.
+        bool lastSpace = false;             // The last character placed was a space.
+        std::size_t breakEnd = std::string::npos, breakNext = begin, breakStops = 0;
+        int breakWidth = 0;
+
+        auto breakAtSpace = [&]() {
+            line.end = breakEnd;
+            line.width = breakWidth;
+            line.stops.resize(breakStops);
+        };
+
+        std::size_t idx = begin;
+        while (idx < mText.size()) {
+            auto pos = idx;
+            auto code = utf8Next(mText, idx);
+
+            if (code == U'\n') {
+                if (content && lastSpace) {
+                    breakAtSpace();
+                } else {
+                    line.end = pos;
+                    line.width = width;
+                }
+                line.next = idx;
+                line.scanEnd = idx;
+                return line;
+            }
+
+            auto codeAdvance = advance(code);
+            if (code == U' ') {
+                if (content && !lastSpace) {
+                    breakEnd = pos;
+                    breakWidth = width;
+                    breakStops = line.stops.size();
+                }
+                lastSpace = true;
+                breakNext = idx;
+            } else {
+                if (pos > begin && width + codeAdvance > mWrapWidth) {
+                    if (breakEnd != std::string::npos) {
+                        breakAtSpace();
+                        line.next = breakNext;
+                    } else {
+                        line.end = pos;
+                        line.width = width;
+                        line.next = pos;
+                    }
+                    line.scanEnd = idx;
+                    return line;
+                }
+                content = true;
+                lastSpace = false;
+            }
+
+            width += codeAdvance;
+            line.stops.emplace_back(idx, width);
+        }
+
+        if (content && lastSpace) {
+            breakAtSpace();
+        } else {
+            line.end = mText.size();
+            line.width = width;
+        }
+        line.next = mText.size();
+        line.scanEnd = mText.size() + 1;    // Appending text may change the last line.
+        return line;
+    }
+
+    void Paragraph::reflow() {
+        if (mWrapWidth <= 0 || !mFont) {
+            mLines.clear();
+            mFlowedText.clear();
+            mFlowedWidth = mWrapWidth;
+            mFlowedFont = mFont;
+            return;
+        }
+
+        if (isColorBaked() && mFlowedColor != mTextFgColor) {
+            for (auto &line : mLines)
+                line.texture.reset();
+            mFlowedColor = mTextFgColor;
+        }
+
+        if (mWrapWidth != mFlowedWidth || mFont != mFlowedFont) {
+            mLines.clear();
+            mFlowedText.clear();
+        } else if (mFlowedText == mText && mFlowedMaxLines == mMaxLines) {
+            return;
+        }
+
+        auto prefix = static_cast<std::size_t>(
+                std::mismatch(mFlowedText.begin(), mFlowedText.end(), mText.begin(), mText.end()).first -
+                mFlowedText.begin());
+        std::size_t suffix = 0;
+        while (suffix < mFlowedText.size() - prefix && suffix < mText.size() - prefix &&
+               mFlowedText[mFlowedText.size() - 1 - suffix] == mText[mText.size() - 1 - suffix])
+            ++suffix;
+
+        auto delta = static_cast<std::ptrdiff_t>(mText.size()) - static_cast<std::ptrdiff_t>(mFlowedText.size());
+        auto oldSuffix = mFlowedText.size() - suffix;
+        auto withinLimit = [this]() { return mMaxLines == 0 || mLines.size() < mMaxLines; };
+
+        std::vector<Line> old{std::move(mLines)};
+        mLines.clear();
+
+        std::size_t oldIdx = 0;
+        for (; oldIdx < old.size() && old[oldIdx].scanEnd <= prefix && withinLimit(); ++oldIdx)
+            mLines.push_back(std::move(old[oldIdx]));
+
+        std::size_t begin = mLines.empty() ? 0 : mLines.back().next;
+        while (begin < mText.size() && withinLimit()) {
+            auto shifted = [&](std::size_t i) { return static_cast<std::ptrdiff_t>(old[i].begin) + delta; };
+            while (oldIdx < old.size() && shifted(oldIdx) < static_cast<std::ptrdiff_t>(begin))
+                ++oldIdx;
+
+            if (oldIdx < old.size() && old[oldIdx].begin >= oldSuffix &&
+                shifted(oldIdx) == static_cast<std::ptrdiff_t>(begin)) {
+                // The rest of the text is unchanged from here, so are the old line breaks.
+                for (; oldIdx < old.size() && withinLimit(); ++oldIdx) {
+                    old[oldIdx].shift(delta);
+                    mLines.push_back(std::move(old[oldIdx]));
+                }
+                begin = mLines.back().next;
+                continue;
+            }
+
+            mLines.push_back(wrapLine(begin));
+            begin = mLines.back().next;
+        }
+
+        mFlowedText = mText;
+        mFlowedWidth = mWrapWidth;
+        mFlowedFont = mFont;
+        mFlowedColor = mTextFgColor;
+        mFlowedMaxLines = mMaxLines;
+        applyEllipsis();
+    }
+
+    void Paragraph::applyEllipsis() {
+        bool truncated = mMaxLines > 0 && mLines.size() == mMaxLines && mLines.back().next < mText.size();
+
+        for (auto &line : mLines) {
+            bool ellipsis = truncated && &line == &mLines.back();
+            auto shownEnd = line.end;
+            auto shownWidth = line.width;
+
+            if (ellipsis) {
+                auto stop = std::upper_bound(line.stops.begin(), line.stops.end(), mWrapWidth - mEllipsisWidth,
+                                             [](int width, const auto &s) { return width < s.second; });
+                shownEnd = stop == line.stops.begin() ? line.begin : std::prev(stop)->first;
+                shownWidth = (stop == line.stops.begin() ? 0 : std::prev(stop)->second) + mEllipsisWidth;
+            }
+
+            if (line.ellipsis != ellipsis || line.shownEnd != shownEnd)
+                line.texture.reset();
+            line.ellipsis = ellipsis;
+            line.shownEnd = shownEnd;
+            line.shownWidth = shownWidth;
+        }
+    }
+
+    bool Paragraph::initialLayout(Context &context) {
+        try {
+            if (!mFont)
+                mFont = getFont(mFontName, mPointSize);
+            if (!mFont)
+                throw TextGadgetException( fmt::format("Font error"));
+
+            mLineSkip = TTF_FontLineSkip(mFont.get());
+            mEllipsisWidth = advance(U'\u2026');
+            reflow();
+
+            int width = 0;
+            for (auto &line : mLines)
+                width = std::max(width, line.shownWidth);
+            mVisualMetrics.desiredSize = Size{width, static_cast<int>(mLines.size()) * mLineSkip};
+        } catch (TextGadgetException &e) {
+            fmt::print("{}\n", e.what());
+        }
+
+        auto result = Gadget::initialLayout(context);
+        // Once a wrap width is known, a change to the space available is passed down by the managers.
+        return result || (mWrapToConstraint && mWrapWidth <= 0);
+    }
+
+    void Paragraph::constrainedGadgetLayout(Context &, Size constraint) {
+        if (mWrapToConstraint) {
+            if (auto width = interiorConstraint(constraint).w; width != mWrapWidth) {
+                mWrapWidth = width;
+                setNeedsDrawing();
+            }
+        }
+    }
+
+    void Paragraph::draw(Context &context, Point drawLocation) {
+        Gadget::draw(context, drawLocation);
+        auto origin = mVisualMetrics.renderRect.point + drawLocation;
+
+        for (std::size_t idx = 0; idx < mLines.size(); ++idx) {
+            auto &line = mLines[idx];
+            Rectangle lineRect{origin.x, origin.y + static_cast<int>(idx) * mLineSkip, line.shownWidth, mLineSkip};
+            if (line.shownWidth == 0 || !context.isVisible(lineRect))
+                continue;
+
+            if (!line.texture) {
+                auto text = mText.substr(line.begin, line.shownEnd - line.begin);
+                if (line.ellipsis)
+                    text.append(Ellipsis);
+                try {
+                    line.texture = renderText(context, text);
+                } catch (TextGadgetException &e) {
+                    fmt::print("{}\n", e.what());
+                    continue;
+                }
+            }
+
+            if (!isColorBaked())
+                line.texture->setColorMod(mTextFgColor);
+            context.renderCopy(*line.texture, Rectangle{lineRect.point, line.texture->getSize()});
+        }
+    }
+
+} // rose
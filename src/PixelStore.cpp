@@ -0,0 +1,264 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * PixelStore.cpp Created by Richard Buckley (C) 18/10/26
+ */
+
+#include "PixelStore.h"
+#include "ImageCache.h"
+#include "XDGBaseDir.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <thread>
+#include <vector>
+#include <fmt/format.h>
+
+namespace rose {
+
+    namespace {
+        /**
+         * @struct PixelHeader
+         * @brief The start of a pixel file.
+         */
+        struct PixelHeader {
+            std::array<char, 8> magic{};
+            uint32_t format{};
+            int32_t width{};
+            int32_t height{};
+            int32_t pitch{};
+        };
+
+        static_assert(sizeof(PixelHeader) <= PixelStore::HeaderSize);
+
+        constexpr std::size_t PageSize = 4096;
+
+        /// Temporary files older than this are left by a writer that failed and are removed by prune().
+        constexpr auto StaleTemporary = std::chrono::hours{1};
+
+        /**
+         * @brief Check that a source file is still the version an ImageKey was made from.
+         */
+        bool unchanged(const ImageKey &key) {
+            std::error_code ec{};
+            auto modified = std::filesystem::last_write_time(key.path, ec);
+            if (ec || static_cast<int64_t>(modified.time_since_epoch().count()) != key.modified)
+                return false;
+            auto size = std::filesystem::file_size(key.path, ec);
+            return !ec && size == key.fileSize;
+        }
+
+        std::filesystem::path temporaryPath(const std::filesystem::path &path) {
+            return std::filesystem::path{fmt::format("{}.{}.tmp", path.string(),
+                                                     std::hash<std::thread::id>{}(std::this_thread::get_id()))};
+        }
+    }
+
+    const void *StoredImage::pixels() const {
+        return mapping.data() + PixelStore::HeaderSize;
+    }
+
+    uint32_t PixelStore::nativeFormat(SDL_Renderer *renderer) {
+        SDL_RendererInfo info{};
+        if (renderer && SDL_GetRendererInfo(renderer, &info) == 0 && info.num_texture_formats > 0) {
+            auto format = info.texture_formats[0];
+            if (!SDL_ISPIXELFORMAT_FOURCC(format) && SDL_ISPIXELFORMAT_ALPHA(format) && SDL_BYTESPERPIXEL(format) == 4)
+                return format;
+        }
+        return SDL_PIXELFORMAT_ARGB8888;
+    }
+
+    std::optional<std::filesystem::path> PixelStore::filePath(const ImageKey &key, uint32_t format) {
+        std::call_once(mLocate, [this]() {
+            if (mDirectory.empty()) {
+                try {
+                    mDirectory = roseCacheDirectory("pixels");
+                } catch (const std::exception &e) {
+                    fmt::print("{}\n", e.what());
+                    mEnabled = false;
+                    return;
+                }
+            }
+            prune();
+        });
+
+        if (!mEnabled)
+            return std::nullopt;
+
+        // Named from the key, not a fresh stat, so the name always describes the version that was decoded.
+        std::error_code ec{};
+        auto absolute = std::filesystem::absolute(key.path, ec);
+        if (ec)
+            return std::nullopt;
+        auto name = fnv1a(fmt::format("{}\n{}\n{}\n{}x{}\n{:08x}", absolute.string(), key.modified, key.fileSize,
+                                      key.width, key.height, format));
+        return mDirectory / fmt::format("{:016x}.pix", name);
+    }
+
+    void PixelStore::prune() {
+        std::lock_guard lock{mPruneMutex};
+        struct PixelFile {
+            std::filesystem::file_time_type used{};
+            std::uintmax_t size{};
+            std::filesystem::path path{};
+        };
+
+        std::vector<PixelFile> files{};
+        std::uintmax_t total = 0;
+        std::error_code ec{};
+        auto now = std::filesystem::file_time_type::clock::now();
+        for (const auto &entry : std::filesystem::directory_iterator{mDirectory, ec}) {
+            if (!entry.is_regular_file(ec))
+                continue;
+            auto used = entry.last_write_time(ec);
+            if (ec)
+                continue;
+            auto &path = entry.path();
+            if (path.extension() == ".tmp") {
+                if (now - used > StaleTemporary)
+                    std::filesystem::remove(path, ec);
+            } else if (path.extension() == ".pix") {
+                auto size = entry.file_size(ec);
+                if (ec)
+                    continue;
+                files.push_back(PixelFile{used, size, path});
+                total += size;
+            }
+        }
+
+        if (total > mBudget) {
+            // Prune to three quarters of the budget so the next few saves do not prune again.
+            std::sort(files.begin(), files.end(), [](const PixelFile &a, const PixelFile &b) {
+                return a.used < b.used;
+            });
+            auto target = mBudget / 4 * 3;
+            for (const auto &file : files) {
+                if (total <= target)
+                    break;
+                if (std::filesystem::remove(file.path, ec))
+                    total -= file.size;
+            }
+        }
+        mBytes = total;
+    }
+
+    std::optional<StoredImage> PixelStore::load(const ImageKey &key, uint32_t format) {
+        auto path = filePath(key, format);
+        std::error_code ec{};
+        if (!path || !std::filesystem::exists(path.value(), ec))
+            return std::nullopt;
+
+        StoredImage image{};
+        try {
+            image.mapping = MappedFile{path.value()};
+        } catch (const MappedFileError &e) {
+            fmt::print("{}\n", e.what());
+            return std::nullopt;
+        }
+
+        PixelHeader header{};
+        if (image.mapping.size() < HeaderSize)
+            return std::nullopt;
+        std::memcpy(&header, image.mapping.data(), sizeof(header));
+        auto bytesPerPixel = static_cast<int>(SDL_BYTESPERPIXEL(format));
+        if (std::string_view{header.magic.data(), header.magic.size()} != Magic || header.format != format ||
+            header.width <= 0 || header.height <= 0 || header.pitch < header.width * bytesPerPixel)
+            return std::nullopt;
+        auto bytes = static_cast<std::size_t>(header.pitch) * static_cast<std::size_t>(header.height);
+        if (image.mapping.size() < HeaderSize + bytes)
+            return std::nullopt;
+
+        // Fault the pages in here rather than in SDL_UpdateTexture on the UI thread.
+        unsigned char sum = 0;
+        auto data = reinterpret_cast<const unsigned char *>(image.mapping.data());
+        for (std::size_t offset = 0; offset < image.mapping.size(); offset += PageSize)
+            sum = static_cast<unsigned char>(sum ^ data[offset]);
+        [[maybe_unused]] volatile unsigned char touched = sum;
+
+        // Mark the file used so prune() keeps it.
+        std::filesystem::last_write_time(path.value(), std::filesystem::file_time_type::clock::now(), ec);
+
+        image.size = Size{header.width, header.height};
+        image.pitch = header.pitch;
+        image.format = header.format;
+        return image;
+    }
+
+    bool PixelStore::save(const ImageKey &key, const Surface &image, uint32_t format) {
+        auto path = filePath(key, format);
+        std::error_code ec{};
+        if (!path || !image)
+            return false;
+        if (std::filesystem::exists(path.value(), ec))
+            return true;
+        if (!unchanged(key))
+            return false;
+
+        Surface converted{};
+        auto source = image.get();
+        if (source->format->format != format) {
+            converted = Surface{SDL_ConvertSurfaceFormat(source, format, 0)};
+            if (!converted) {
+                fmt::print("Pixel store convert error: {} -- {}\n", key.path, SDL_GetError());
+                return false;
+            }
+            source = converted.get();
+        }
+
+        PixelHeader header{};
+        std::memcpy(header.magic.data(), Magic.data(), header.magic.size());
+        header.format = format;
+        header.width = source->w;
+        header.height = source->h;
+        header.pitch = source->w * static_cast<int>(SDL_BYTESPERPIXEL(format));
+
+        std::array<char, HeaderSize> prefix{};
+        std::memcpy(prefix.data(), &header, sizeof(header));
+
+        auto temporary = temporaryPath(path.value());
+        {
+            std::ofstream file{temporary, std::ios::binary | std::ios::trunc};
+            file.write(prefix.data(), prefix.size());
+            auto row = static_cast<const char *>(source->pixels);
+            for (int y = 0; y < source->h && file; ++y, row += source->pitch)
+                file.write(row, header.pitch);
+            if (!file) {
+                fmt::print("Pixel store write error: {}\n", temporary.string());
+                file.close();
+                std::filesystem::remove(temporary, ec);
+                return false;
+            }
+        }
+
+        std::filesystem::rename(temporary, path.value(), ec);
+        if (ec) {
+            std::filesystem::remove(temporary, ec);
+            return false;
+        }
+
+        auto bytes = HeaderSize +
+                     static_cast<std::uintmax_t>(header.pitch) * static_cast<std::uintmax_t>(header.height);
+        if (mBytes.fetch_add(bytes) + bytes > mBudget)
+            prune();
+        return true;
+    }
+
+    Texture PixelStore::upload(Context &context, const StoredImage &image) {
+        Texture texture{context, static_cast<SDL_PixelFormatEnum>(image.format), SDL_TEXTUREACCESS_STATIC,
+                        image.size.w, image.size.h};
+        if (!texture) {
+            fmt::print("Pixel store texture error: {}\n", SDL_GetError());
+            return texture;
+        }
+        if (SDL_UpdateTexture(texture.get(), nullptr, image.pixels(), image.pitch)) {
+            fmt::print("Pixel store upload error: {}\n", SDL_GetError());
+            return Texture{};
+        }
+        texture.setBlendMode(SDL_BLENDMODE_BLEND);
+        return texture;
+    }
+
+} // rose
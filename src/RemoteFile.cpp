@@ -0,0 +1,197 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * RemoteFile.cpp Created by Richard Buckley (C) 18/10/26
+ */
+
+#include "RemoteFile.h"
+#include "XDGBaseDir.h"
+#include <algorithm>
+#include <fstream>
+#include <list>
+#include <thread>
+#include <unordered_map>
+#include <curlpp/cURLpp.hpp>
+#include <curlpp/Easy.hpp>
+#include <curlpp/Infos.hpp>
+#include <curlpp/Options.hpp>
+#include <fmt/format.h>
+
+namespace rose {
+
+    namespace {
+        constexpr long HttpOk = 200;
+        constexpr long HttpNotModified = 304;
+
+        /**
+         * @brief Initialize libcurl once, before the first request, and clean up at exit.
+         */
+        void initializeCurl() {
+            static curlpp::Cleanup cleanup{};
+        }
+
+        /**
+         * @brief Match an HTTP header name, which is case insensitive.
+         * @return The value with surrounding white space removed, or an empty string if the name does not match.
+         */
+        std::string headerValue(std::string_view line, std::string_view name) {
+            if (line.size() <= name.size() || line[name.size()] != ':' ||
+                !std::equal(name.begin(), name.end(), line.begin(), [](char a, char b) {
+                    return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+                }))
+                return std::string{};
+
+            auto value = line.substr(name.size() + 1);
+            auto first = value.find_first_not_of(" \t");
+            auto last = value.find_last_not_of(" \t\r\n");
+            if (first == std::string_view::npos)
+                return std::string{};
+            return std::string{value.substr(first, last - first + 1)};
+        }
+
+        /**
+         * @brief A name to write to before renaming, unique to the fetching thread.
+         */
+        std::filesystem::path temporaryPath(const std::filesystem::path &path) {
+            return std::filesystem::path{fmt::format("{}.{}.tmp", path.string(),
+                                                     std::hash<std::thread::id>{}(std::this_thread::get_id()))};
+        }
+    }
+
+    std::shared_ptr<RemoteFile>
+    RemoteFile::shared(const std::string &url, const std::filesystem::path &cacheDirectory) {
+        static std::mutex mutex{};
+        static std::unordered_map<std::string, std::weak_ptr<RemoteFile>> files{};
+
+        auto key = fmt::format("{}\n{}", cacheDirectory.string(), url);
+        std::lock_guard lock{mutex};
+        if (auto file = files[key].lock(); file)
+            return file;
+        std::erase_if(files, [](const auto &entry) { return entry.second.expired(); });
+        auto file = std::make_shared<RemoteFile>(url, cacheDirectory);
+        files[key] = file;
+        return file;
+    }
+
+    RemoteFile::RemoteFile(std::string url, const std::filesystem::path &cacheDirectory) : mUrl(std::move(url)) {
+        auto directory = cacheDirectory.empty() ? roseCacheDirectory("http") : cacheDirectory;
+        auto name = fmt::format("{:016x}", fnv1a(mUrl));
+        mBodyPath = directory / (name + ".body");
+        mMetaPath = directory / (name + ".meta");
+    }
+
+    void RemoteFile::loadMeta() {
+        mMetaLoaded = true;
+        std::ifstream meta{mMetaPath};
+        std::string version{};
+        if (!meta || !std::getline(meta, version) || version != MetaVersion)
+            return;
+        std::getline(meta, mETag);
+        std::getline(meta, mLastModified);
+    }
+
+    void RemoteFile::saveMeta() const {
+        std::error_code ec{};
+        auto temporary = temporaryPath(mMetaPath);
+        {
+            std::ofstream meta{temporary};
+            meta << MetaVersion << '\n' << mETag << '\n' << mLastModified << '\n';
+            if (!meta) {
+                fmt::print("Can not write '{}'\n", mMetaPath.string());
+                meta.close();
+                std::filesystem::remove(temporary, ec);
+                return;
+            }
+        }
+        std::filesystem::rename(temporary, mMetaPath, ec);
+        if (ec) {
+            fmt::print("Can not write '{}': {}\n", mMetaPath.string(), ec.message());
+            std::filesystem::remove(temporary, ec);
+        }
+    }
+
+    RemoteFile::Status RemoteFile::fetch() {
+        std::lock_guard fetchLock{mFetchMutex};
+        initializeCurl();
+        if (!mMetaLoaded)
+            loadMeta();
+
+        std::error_code ec{};
+        std::filesystem::create_directories(mBodyPath.parent_path(), ec);
+
+        // Only ask for a 304 when there is a body to fall back on.
+        std::list<std::string> headers{};
+        if (std::filesystem::exists(mBodyPath, ec)) {
+            if (!mETag.empty())
+                headers.push_back(fmt::format("If-None-Match: {}", mETag));
+            if (!mLastModified.empty())
+                headers.push_back(fmt::format("If-Modified-Since: {}", mLastModified));
+        }
+
+        auto temporary = temporaryPath(mBodyPath);
+        std::ofstream body{temporary, std::ios::binary | std::ios::trunc};
+        if (!body) {
+            fmt::print("Can not write '{}'\n", temporary.string());
+            return Status::Failed;
+        }
+
+        std::string eTag{}, lastModified{};
+        long responseCode{};
+        try {
+            curlpp::Easy request{};
+            request.setOpt(curlpp::options::Url(mUrl));
+            request.setOpt(curlpp::options::FollowLocation(true));
+            request.setOpt(curlpp::options::NoSignal(true));
+            request.setOpt(curlpp::options::ConnectTimeout(ConnectTimeout));
+            request.setOpt(curlpp::options::Timeout(TransferTimeout));
+            request.setOpt(curlpp::options::HttpHeader(headers));
+            request.setOpt(curlpp::options::WriteFunction([&body](char *data, size_t size, size_t count) -> size_t {
+                body.write(data, static_cast<std::streamsize>(size * count));
+                return body ? size * count : 0;
+            }));
+            request.setOpt(curlpp::options::HeaderFunction([&](char *data, size_t size, size_t count) -> size_t {
+                std::string_view line{data, size * count};
+                if (line.starts_with("HTTP/")) {
+                    // Each response of a redirect chain starts with a status line.
+                    eTag.clear();
+                    lastModified.clear();
+                } else if (auto value = headerValue(line, "ETag"); !value.empty()) {
+                    eTag = value;
+                } else if (auto modified = headerValue(line, "Last-Modified"); !modified.empty()) {
+                    lastModified = modified;
+                }
+                return size * count;
+            }));
+            request.perform();
+            responseCode = curlpp::infos::ResponseCode::get(request);
+        } catch (const std::exception &e) {
+            fmt::print("Fetch '{}': {}\n", mUrl, e.what());
+            body.close();
+            std::filesystem::remove(temporary, ec);
+            return Status::Failed;
+        }
+
+        body.close();
+        if (responseCode == HttpOk && body) {
+            std::filesystem::rename(temporary, mBodyPath, ec);
+            if (ec) {
+                fmt::print("Can not write '{}': {}\n", mBodyPath.string(), ec.message());
+                std::filesystem::remove(temporary, ec);
+                return Status::Failed;
+            }
+            mETag = eTag;
+            mLastModified = lastModified;
+            saveMeta();
+            return Status::Changed;
+        }
+
+        std::filesystem::remove(temporary, ec);
+        if (responseCode == HttpNotModified)
+            return Status::NotModified;
+        fmt::print("Fetch '{}': HTTP status {}\n", mUrl, responseCode);
+        return Status::Failed;
+    }
+
+} // rose
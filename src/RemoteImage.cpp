@@ -0,0 +1,89 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * RemoteImage.cpp Created by Richard Buckley (C) 18/10/26
+ */
+
+#include "RemoteImage.h"
+#include <Application.h>
+#include <ImageDecode.h>
+#include <algorithm>
+
+namespace rose {
+
+    void RemoteImage::initialize() {
+        Image::initialize();
+        mAnimationSlot = AnimationProtocol::createSlot();
+        mAnimationSlot->receiver = [this](uint64_t ticks) { refresh(ticks); };
+        if (auto application = getApplicationPtr(); application)
+            application->animationSignal.connect(mAnimationSlot);
+    }
+
+    void RemoteImage::setUrl(const std::string &url) {
+        if (mRemote && mRemote->url() == url)
+            return;
+        try {
+            mRemote = RemoteFile::shared(url, mCacheDirectory);
+        } catch (const std::exception &e) {
+            fmt::print("{}\n", e.what());
+            mRemote.reset();
+            return;
+        }
+        mNextFetch = 0;
+        mRetryDelay = InitialRetryDelay;
+        mFetchInFlight = false;
+        ++mFetchGeneration;
+        setFilePath(mRemote->bodyPath());
+    }
+
+    void RemoteImage::setCacheDirectory(const std::filesystem::path &directory) {
+        if (mCacheDirectory == directory)
+            return;
+        mCacheDirectory = directory;
+        if (mRemote) {
+            auto url = mRemote->url();
+            mRemote.reset();
+            setUrl(url);
+        }
+    }
+
+    void RemoteImage::refresh(uint64_t ticks) {
+        auto application = getApplicationPtr();
+        if (!mRemote || mFetchInFlight || ticks < mNextFetch || !application)
+            return;
+        mFetchInFlight = true;
+
+        std::weak_ptr<Gadget> weak = shared_from_this();
+        auto generation = mFetchGeneration;
+        application->workerPool().submit([weak, remote = mRemote, generation]() -> WorkerPool::Completion {
+            auto status = remote->fetch();
+            Size size{};
+            // The header is read here so the UI thread only has to request the decode.
+            if (status == RemoteFile::Status::Changed)
+                size = imageFileSize(remote->bodyPath()).value_or(Size{});
+            return [weak, status, size, generation]() {
+                if (auto image = std::dynamic_pointer_cast<RemoteImage>(weak.lock()); image)
+                    image->fetchDone(status, size, generation);
+            };
+        });
+    }
+
+    void RemoteImage::fetchDone(RemoteFile::Status status, Size naturalSize, uint64_t generation) {
+        if (generation != mFetchGeneration)
+            return;
+        mFetchInFlight = false;
+        if (status == RemoteFile::Status::Failed) {
+            mNextFetch = SDL_GetTicks64() + std::min(mRetryDelay, mRefreshInterval);
+            mRetryDelay = std::min(mRetryDelay * 2, mRefreshInterval);
+            return;
+        }
+
+        mRetryDelay = InitialRetryDelay;
+        mNextFetch = SDL_GetTicks64() + mRefreshInterval;
+        if (status == RemoteFile::Status::Changed)
+            fileChanged(naturalSize);
+    }
+
+} // rose
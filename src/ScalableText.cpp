@@ -0,0 +1,73 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * ScalableText.cpp Created by Richard Buckley (C) 18/10/26
+ */
+
+#include "ScalableText.h"
+#include <cmath>
+
+namespace rose {
+
+    bool ScalableText::initialLayout(Context &context) {
+        mCodes = utf32(mText);
+        try {
+            if (!mReferenceFont || mReferenceFontName != mFontName) {
+                mReferenceFont = getFont(mFontName, mReferenceSize);
+                mReferenceFontName = mFontName;
+                mAtlas.reset();
+            }
+            if (!mReferenceFont)
+                throw TextGadgetException( fmt::format("Font error"));
+
+            mReferenceWidth = 0;
+            for (auto code : mCodes)
+                mReferenceWidth += getGlyphMetrics32(mReferenceFont, static_cast<Uint32>(code)).advance;
+            mReferenceHeight = TTF_FontHeight(mReferenceFont.get());
+
+            auto ratio = static_cast<float>(mPointSize) / static_cast<float>(mReferenceSize);
+            mVisualMetrics.desiredSize = Size{static_cast<int>(std::ceil(static_cast<float>(mReferenceWidth) * ratio)),
+                                              static_cast<int>(std::ceil(static_cast<float>(mReferenceHeight) * ratio))};
+        } catch (TextGadgetException &e) {
+            fmt::print("{}\n", e.what());
+        }
+        return Gadget::initialLayout(context);
+    }
+
+    void ScalableText::draw(Context &context, Point drawLocation) {
+        Gadget::draw(context, drawLocation);
+        if (mCodes.empty() || !mReferenceFont)
+            return;
+
+        if (!mAtlas || mAtlas->font() != mReferenceFont) {
+            if (auto cache = textureCache(); cache)
+                mAtlas = cache->glyphAtlas(context, mFontName, mReferenceSize, mReferenceFont);
+            else
+                mAtlas = std::make_shared<GlyphAtlas>(mReferenceFont);
+            mReferenceFont = mAtlas->font();
+            mAtlas->preload(context, mCodes);
+        }
+
+        auto rect = mVisualMetrics.renderRect + drawLocation;
+        auto k = static_cast<float>(mPointSize) * mScale / static_cast<float>(mReferenceSize);
+        auto x = static_cast<float>(rect.point.x) +
+                 (static_cast<float>(rect.size.w) - static_cast<float>(mReferenceWidth) * k) / 2.f;
+        auto y = static_cast<float>(rect.point.y) +
+                 (static_cast<float>(rect.size.h) - static_cast<float>(mReferenceHeight) * k) / 2.f;
+
+        for (auto code : mCodes) {
+            auto glyphCode = static_cast<uint32_t>(code);
+            if (auto glyph = mAtlas->glyph(context, glyphCode); glyph) {
+                Rectangle dst{static_cast<int>(std::lround(x)), static_cast<int>(std::lround(y)),
+                              static_cast<int>(std::lround(static_cast<float>(glyph->rect.size.w) * k)),
+                              static_cast<int>(std::lround(static_cast<float>(glyph->rect.size.h) * k))};
+                if (context.isVisible(dst))
+                    mAtlas->render(context, *glyph, dst, mTextFgColor);
+            }
+            x += static_cast<float>(getGlyphMetrics32(mReferenceFont, glyphCode).advance) * k;
+        }
+    }
+
+} // rose
@@ -15,6 +15,8 @@
 
 #include <SDL_image.h>
 #include "Surface.h"
+#include <algorithm>
+#include <cstddef>
 
 namespace rose {
 
@@ -42,6 +44,59 @@ namespace rose {
         }
     }
 
+    Rectangle Surface::alphaBounds() const {
+        if (!operator bool())
+            return Rectangle{};
+
+        auto amask = get()->format->Amask;
+        if (!amask)
+            return Rectangle{0, 0, get()->w, get()->h};
+
+        Surface converted{};
+        SDL_Surface *surface = get();
+        if (surface->format->BytesPerPixel != 4) {
+            converted.reset(SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0));
+            if (!converted)
+                return Rectangle{0, 0, get()->w, get()->h};
+            surface = converted.get();
+            amask = surface->format->Amask;
+        }
+
+        SurfaceLock lock{surface};
+        if (!lock)
+            return Rectangle{0, 0, surface->w, surface->h};
+
+        int minX = surface->w, maxX = -1, minY = surface->h, maxY = -1;
+        for (int y = 0; y < surface->h; ++y) {
+            auto row = reinterpret_cast<const uint32_t *>(static_cast<const uint8_t *>(surface->pixels) +
+                                                          static_cast<std::ptrdiff_t>(y) * surface->pitch);
+            uint32_t any = 0;
+            for (int x = 0; x < surface->w; ++x)
+                any |= row[x];
+            if (!(any & amask))
+                continue;
+
+            minY = std::min(minY, y);
+            maxY = y;
+            for (int x = 0; x < minX; ++x) {
+                if (row[x] & amask) {
+                    minX = x;
+                    break;
+                }
+            }
+            for (int x = surface->w - 1; x > maxX; --x) {
+                if (row[x] & amask) {
+                    maxX = x;
+                    break;
+                }
+            }
+        }
+
+        if (maxY < 0)
+            return Rectangle{};
+        return Rectangle{minX, minY, maxX - minX + 1, maxY - minY + 1};
+    }
+
     uint32_t &Surface::pixel(int x, int y) const {
         auto *pixels = (Uint32 *) get()->pixels;
         return pixels[(y * get()->w) + x];
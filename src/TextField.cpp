@@ -0,0 +1,366 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * TextField.cpp Created by Richard Buckley (C) 18/10/26
+ */
+
+#include "TextField.h"
+#include "manager/Window.h"
+#include <Application.h>
+#include <limits>
+
+namespace rose {
+
+    TextField::RunPosition TextField::findRun(std::size_t position, bool atEnd) const {
+        RunPosition run{};
+        for (; run.index < mRuns.size(); ++run.index) {
+            auto end = run.start + mRuns[run.index].length;
+            if (position < end || (atEnd && position == end))
+                break;
+            run.start = end;
+            run.offset += mRuns[run.index].width;
+        }
+        return run;
+    }
+
+    void TextField::measureRuns() {
+        std::vector<int> advances(mCodes.size());
+        for (std::size_t idx = 0; idx < mCodes.size(); ++idx)
+            advances[idx] = getGlyphMetrics32(mFont, static_cast<Uint32>(mCodes[idx])).advance;
+        mAdvances.clear();
+        mAdvances.insert(0, advances.begin(), advances.end());
+
+        mRuns.clear();
+        for (std::size_t start = 0; start < advances.size(); start += RunLength) {
+            Run run{std::min(RunLength, advances.size() - start)};
+            for (std::size_t idx = start; idx < start + run.length; ++idx)
+                run.width += advances[idx];
+            mRuns.push_back(std::move(run));
+        }
+
+        mMeasuredFont = mFont;
+        mCaretOffset = caretOffset();
+    }
+
+    void TextField::loadText() {
+        auto codes = utf32(mText);
+        mCodes.clear();
+        mCodes.insert(0, codes.begin(), codes.end());
+        mCaret = mCodes.size();
+        mScroll = 0;
+        mLoadRequired = false;
+        measureRuns();
+    }
+
+    void TextField::insertCodes(std::u32string_view codes) {
+        if (codes.empty() || mLoadRequired || !mFont)
+            return;
+
+        if (mRuns.empty())
+            mRuns.emplace_back();
+        auto position = findRun(mCaret, true);
+        auto &run = mRuns[position.index];
+
+        std::vector<int> advances{};
+        advances.reserve(codes.size());
+        for (auto code : codes) {
+            advances.push_back(getGlyphMetrics32(mFont, static_cast<Uint32>(code)).advance);
+            run.width += advances.back();
+        }
+        mCodes.insert(mCaret, codes.begin(), codes.end());
+        mAdvances.insert(mCaret, advances.begin(), advances.end());
+        run.length += codes.size();
+        run.texture.reset();
+
+        if (run.length > 2 * RunLength) {
+            Run tail{};
+            auto split = position.start + run.length / 2;
+            for (auto idx = split; idx < position.start + run.length; ++idx)
+                tail.width += mAdvances[idx];
+            tail.length = position.start + run.length - split;
+            run.length -= tail.length;
+            run.width -= tail.width;
+            mRuns.insert(mRuns.begin() + static_cast<std::ptrdiff_t>(position.index + 1), std::move(tail));
+        }
+
+        mCaret += codes.size();
+        mCaretOffset = caretOffset();
+        showCaret();
+        if (scrollToCaret())
+            exposeText(mScroll);
+        else
+            exposeText(position.offset);
+    }
+
+    bool TextField::eraseCode(std::size_t position) {
+        if (position >= mCodes.size() || mLoadRequired)
+            return false;
+
+        auto runPosition = findRun(position, false);
+        auto &run = mRuns[runPosition.index];
+        run.width -= mAdvances[position];
+        run.length -= 1;
+        run.texture.reset();
+        mCodes.erase(position);
+        mAdvances.erase(position);
+
+        auto index = static_cast<std::ptrdiff_t>(runPosition.index);
+        if (run.length == 0) {
+            mRuns.erase(mRuns.begin() + index);
+        } else if (runPosition.index + 1 < mRuns.size() && run.length + mRuns[runPosition.index + 1].length <= RunLength) {
+            run.length += mRuns[runPosition.index + 1].length;
+            run.width += mRuns[runPosition.index + 1].width;
+            mRuns.erase(mRuns.begin() + index + 1);
+        }
+
+        // A glyph erased before the caret moves it back.
+        if (position < mCaret)
+            --mCaret;
+        mCaretOffset = caretOffset();
+        showCaret();
+        if (scrollToCaret())
+            exposeText(mScroll);
+        else
+            exposeText(runPosition.offset);
+        return true;
+    }
+
+    void TextField::moveCaret(std::size_t position) {
+        position = std::min(position, mCodes.size());
+        if (position == mCaret)
+            return;
+
+        exposeCaret();
+        mCaret = position;
+        mCaretOffset = caretOffset();
+        showCaret();
+        if (scrollToCaret())
+            exposeText(mScroll);
+        else
+            exposeCaret();
+    }
+
+    int TextField::caretOffset() const {
+        auto run = findRun(mCaret, true);
+        auto offset = run.offset;
+        for (auto idx = run.start; idx < mCaret; ++idx)
+            offset += mAdvances[idx];
+        return offset;
+    }
+
+    std::size_t TextField::positionAt(int offset) const {
+        std::size_t start = 0;
+        int runOffset = 0;
+        for (const auto &run : mRuns) {
+            if (offset < runOffset + run.width) {
+                for (auto idx = start; idx < start + run.length; ++idx) {
+                    if (offset < runOffset + mAdvances[idx] / 2)
+                        return idx;
+                    runOffset += mAdvances[idx];
+                }
+                return start + run.length;
+            }
+            start += run.length;
+            runOffset += run.width;
+        }
+        return mCodes.size();
+    }
+
+    std::string TextField::runText(std::size_t start, std::size_t length) const {
+        std::string text{};
+        text.reserve(length);
+        for (auto idx = start; idx < start + length; ++idx) {
+            auto sequence = utf8(static_cast<unsigned int>(mCodes[idx]));
+            text.append(reinterpret_cast<const char *>(sequence.data()));
+        }
+        return text;
+    }
+
+    bool TextField::scrollToCaret() {
+        auto width = mVisualMetrics.renderRect.size.w;
+        auto scroll = mScroll;
+        if (mCaretOffset - mScroll > width - CaretWidth)
+            scroll = mCaretOffset - width + CaretWidth;
+        if (mCaretOffset < scroll)
+            scroll = mCaretOffset;
+        scroll = std::max(scroll, 0);
+        if (scroll != mScroll) {
+            mScroll = scroll;
+            return true;
+        }
+        return false;
+    }
+
+    void TextField::exposeText(int offset) {
+        auto window = getWindow();
+        if (!window || !mVisualMetrics.lastDrawLocation) {
+            setNeedsDrawing();
+            return;
+        }
+
+        auto field = mVisualMetrics.renderRect + mVisualMetrics.lastDrawLocation;
+        auto right = field.point.x + field.size.w;
+        auto x = std::clamp(field.point.x + offset - mScroll, field.point.x, right);
+        window->expose(Rectangle{x, field.point.y, right - x, field.size.h});
+    }
+
+    void TextField::exposeCaret() {
+        auto window = getWindow();
+        if (!window || !mVisualMetrics.lastDrawLocation) {
+            setNeedsDrawing();
+            return;
+        }
+
+        auto field = mVisualMetrics.renderRect + mVisualMetrics.lastDrawLocation;
+        window->expose(Rectangle{field.point.x + mCaretOffset - mScroll, field.point.y, CaretWidth, mLineHeight});
+    }
+
+    void TextField::showCaret() {
+        mCaretOn = true;
+        mCaretTick = SDL_GetTicks64();
+    }
+
+    void TextField::blinkCaret(uint64_t ticks) {
+        if (!mVisualMetrics.mHasFocus || ticks - mCaretTick < CaretBlinkPeriod)
+            return;
+        mCaretOn = !mCaretOn;
+        mCaretTick = ticks;
+        exposeCaret();
+    }
+
+    void TextField::initialize() {
+        TextGadget::initialize();
+        mCaretSlot = AnimationProtocol::createSlot();
+        mCaretSlot->receiver = [this](uint64_t ticks) { blinkCaret(ticks); };
+        if (auto application = getApplicationPtr(); application)
+            application->animationSignal.connect(mCaretSlot);
+    }
+
+    bool TextField::initialLayout(Context &context) {
+        try {
+            if (!mFont)
+                mFont = getFont(mFontName, mPointSize);
+            if (!mFont)
+                throw TextGadgetException( fmt::format("Font error"));
+
+            mLineHeight = TTF_FontHeight(mFont.get());
+            if (mLoadRequired)
+                loadText();
+            else if (mFont != mMeasuredFont)
+                measureRuns();
+
+            auto digit = getGlyphMetrics32(mFont, static_cast<Uint32>(U'0')).advance;
+            mVisualMetrics.desiredSize = Size{static_cast<int>(mColumns) * digit + CaretWidth, mLineHeight};
+        } catch (TextGadgetException &e) {
+            fmt::print("{}\n", e.what());
+        }
+
+        auto result = Gadget::initialLayout(context);
+        scrollToCaret();
+        return result;
+    }
+
+    void TextField::draw(Context &context, Point drawLocation) {
+        Gadget::draw(context, drawLocation);
+        auto field = mVisualMetrics.renderRect + drawLocation;
+        ClipRectangleGuard clipRectangleGuard{context};
+        clipRectangleGuard.intersection(field);
+
+        auto x = field.point.x - mScroll;
+        std::size_t start = 0;
+        for (auto &run : mRuns) {
+            Rectangle runRect{x, field.point.y, run.width, mLineHeight};
+            if (run.length > 0 && x + run.width > field.point.x && x < field.point.x + field.size.w &&
+                context.isVisible(runRect)) {
+                if (!run.texture) {
+                    try {
+                        run.texture = renderText(context, runText(start, run.length));
+                    } catch (TextGadgetException &e) {
+                        fmt::print("{}\n", e.what());
+                    }
+                }
+                if (run.texture) {
+                    if (!isColorBaked())
+                        run.texture->setColorMod(mTextFgColor);
+                    context.renderCopy(*run.texture, Rectangle{runRect.point, run.texture->getSize()});
+                }
+            }
+            x += run.width;
+            start += run.length;
+        }
+
+        if (mVisualMetrics.mHasFocus && mCaretOn)
+            context.fillRect(Rectangle{field.point.x + mCaretOffset - mScroll, field.point.y, CaretWidth,
+                                       mLineHeight}, mTextFgColor);
+    }
+
+    bool TextField::mouseButtonEvent(const SDL_MouseButtonEvent &e) {
+        if (e.button != SDL_BUTTON_LEFT)
+            return TextGadget::mouseButtonEvent(e);
+
+        if (e.state == SDL_PRESSED) {
+            if (!mVisualMetrics.mHasFocus) {
+                if (auto window = getWindow(); window) {
+                    std::shared_ptr<Gadget> gadget = shared_from_this();
+                    window->setFocusGadget(gadget);
+                }
+            }
+            auto field = mVisualMetrics.renderRect + mVisualMetrics.lastDrawLocation;
+            moveCaret(positionAt(e.x - field.point.x + mScroll));
+        }
+        return true;
+    }
+
+    bool TextField::keyboardEvent(const SDL_KeyboardEvent &e) {
+        if (e.state == SDL_PRESSED) {
+            switch (e.keysym.sym) {
+                case SDLK_LEFT:
+                    if (mCaret > 0)
+                        moveCaret(mCaret - 1);
+                    return true;
+                case SDLK_RIGHT:
+                    moveCaret(mCaret + 1);
+                    return true;
+                case SDLK_HOME:
+                    moveCaret(0);
+                    return true;
+                case SDLK_END:
+                    moveCaret(mCodes.size());
+                    return true;
+                case SDLK_BACKSPACE:
+                    if (mCaret > 0)
+                        eraseCode(mCaret - 1);
+                    return true;
+                case SDLK_DELETE:
+                    eraseCode(mCaret);
+                    return true;
+                case SDLK_RETURN:
+                case SDLK_KP_ENTER:
+                    enterSignal.transmit(text(), timestamp32to64(e.timestamp));
+                    return true;
+                default:
+                    break;
+            }
+        }
+        return TextGadget::keyboardEvent(e);
+    }
+
+    bool TextField::textInputEvent(const SDL_TextInputEvent &e) {
+        insertCodes(utf32(e.text));
+        return true;
+    }
+
+    void TextField::keyboardFocusEvent(bool focus) {
+        if (focus) {
+            SDL_StartTextInput();
+            showCaret();
+        } else {
+            SDL_StopTextInput();
+            mCaretOn = false;
+        }
+        exposeCaret();
+    }
+
+} // rose
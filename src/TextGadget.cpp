@@ -8,10 +8,15 @@
 #include "TextGadget.h"
 #include "manager/Window.h"
 #include <Application.h>
+#include <TextRasterizer.h>
 
 namespace rose {
     std::unique_ptr<Material> IconGadget::mMaterial{};
 
+    std::unique_ptr<IconSheet> IconGadget::mIconSheet{};
+
+    std::unordered_map<uint64_t, Size> IconGadget::mTrimSizes{};
+
     std::unique_ptr<FontCache> TextGadget::mFontCache{};
 
     TextGadget::TextGadget(std::shared_ptr<Theme> &theme) : Gadget(theme) {
@@ -22,41 +27,160 @@ namespace rose {
         mVisualMetrics.gadgetPadding = theme->textPadding;
     }
 
+    TextureCache *TextGadget::textureCache() {
+        if (auto screen = getScreen(); screen) {
+            if (auto application = getApplicationPtr(); application)
+                return &application->textureCache();
+        }
+        return nullptr;
+    }
+
+    SharedTexture TextGadget::sheetTexture(Context &context, const std::string &name, Surface &sheet) {
+        if (auto cache = textureCache(); cache)
+            return cache->sheetTexture(context, name, sheet);
+        auto texture = std::make_shared<Texture>(sheet.toTexture(context));
+        texture->setBlendMode(SDL_BLENDMODE_BLEND);
+        return texture;
+    }
+
+    TextTextureKey TextGadget::textureKey(Context &context, const std::string &text) const {
+        auto fgColor = isColorBaked() ? mTextFgColor : color::OpaqueWhite;
+        return TextTextureKey{context.get(), mFontName, mPointSize, mRenderStyle, TextTextureKey::pack(fgColor),
+                              isColorBaked() ? TextTextureKey::pack(mVisualMetrics.background) : 0u, text};
+    }
+
+    SharedTexture TextGadget::renderText(Context &context, const std::string &text) {
+        if (!mFont) {
+            mFont = getFont(mFontName, mPointSize);
+        }
+
+        if (!mFont)
+            throw TextGadgetException( fmt::format("Font error"));
+
+        auto fgColor = isColorBaked() ? mTextFgColor : color::OpaqueWhite;
+        auto key = textureKey(context, text);
+
+        auto cache = textureCache();
+        if (cache) {
+            if (auto texture = cache->findText(key); texture)
+                return texture;
+        }
+
+        Surface surface{};
+        switch (mRenderStyle) {
+            case RenderStyle::Blended:
+                surface.reset(TTF_RenderUTF8_Blended(mFont.get(), text.c_str(), fgColor.sdlColor()));
+                break;
+            case RenderStyle::Shaded:
+                surface.reset(
+                        TTF_RenderUTF8_Shaded(mFont.get(), text.c_str(), fgColor.sdlColor(),
+                                              mVisualMetrics.background.sdlColor()));
+                break;
+            case RenderStyle::Solid:
+                surface.reset(TTF_RenderUTF8_Solid(mFont.get(), text.c_str(), fgColor.sdlColor()));
+                break;
+        }
+        if (!surface)
+            throw TextGadgetException( fmt::format("Surface error: {}", SDL_GetError()));
+
+        Texture texture{};
+        texture.reset(SDL_CreateTextureFromSurface(context.get(), surface.get()));
+        if (!texture)
+            throw TextGadgetException( fmt::format("Texture error: {}", SDL_GetError()));
+        return cache ? cache->insertText(key, std::move(texture)) : std::make_shared<Texture>(std::move(texture));
+    }
+
     void TextGadget::createTexture(Context &context) {
         if (mText.empty())
             return;
 
+        mTextRenderRequired = false;
+        mTextSize = Size();
+        mTexture = renderText(context, mText);
+        mTextSize = mTexture->getSize();
+    }
+
+    std::shared_ptr<MappedFile> TextGadget::fontFile() {
+        if (!mFontCache)
+            return nullptr;
+        if (auto file = mFontCache->fontFile(mFontName); file)
+            return file;
+        return mFontCache->fontFile("FreeSans");
+    }
+
+    void TextGadget::requestTexture(Context &context, const std::string &text) {
+        mTextRenderRequired = false;
+        auto key = textureKey(context, text);
+        auto cache = textureCache();
+        if (cache) {
+            if (auto texture = cache->findText(key); texture) {
+                mTexture = texture;
+                mTextSize = mTexture->getSize();
+                return;
+            }
+        }
+
+        auto file = cache ? fontFile() : nullptr;
+        if (!file) {
+            mTexture = renderText(context, text);
+            mTextSize = mTexture->getSize();
+            return;
+        }
+
+        TextRasterRequest request{file, mPointSize, mRenderStyle,
+                                  isColorBaked() ? mTextFgColor : color::OpaqueWhite, mVisualMetrics.background, text};
+        std::weak_ptr<Gadget> weak = shared_from_this();
+        auto generation = ++mRenderGeneration;
+        getApplicationPtr()->workerPool().submit(
+                [request = std::move(request), key = std::move(key), weak, generation]() -> WorkerPool::Completion {
+                    auto surface = std::make_shared<Surface>(rasterizeText(request));
+                    return [surface, key, weak, generation]() {
+                        if (auto gadget = std::dynamic_pointer_cast<TextGadget>(weak.lock()); gadget)
+                            gadget->textureReady(key, *surface, generation);
+                    };
+                });
+    }
+
+    void TextGadget::textureReady(const TextTextureKey &key, Surface &surface, uint64_t generation) {
+        auto window = getWindow();
+        if (!surface || !window || window->context().get() != key.renderer)
+            return;
+
+        SharedTexture shared{};
+        try {
+            auto texture = surface.toTexture(window->context());
+            auto cache = textureCache();
+            shared = cache ? cache->insertText(key, std::move(texture)) : std::make_shared<Texture>(std::move(texture));
+        } catch (const SurfaceRuntimeError &e) {
+            fmt::print("{}\n", e.what());
+            return;
+        }
+        if (generation == mRenderGeneration) {
+            mTexture = shared;
+            mTextSize = mTexture->getSize();
+            setNeedsDrawing();
+        }
+    }
+
+    void TextGadget::measureText() {
+        if (mText.empty())
+            return;
+
+        if (auto bitmap = bitmapFont(); bitmap) {
+            mTextSize = bitmap->textSize(mText);
+            return;
+        }
+
         if (!mFont) {
             mFont = getFont(mFontName, mPointSize);
         }
 
         mTextSize = Size();
         if (mFont) {
-            Surface surface{};
-            auto textAndSuffix = mText;
-            auto fgColor = mTextFgColor;
-
-            switch (mRenderStyle) {
-                case RenderStyle::Blended:
-                    surface.reset(TTF_RenderUTF8_Blended(mFont.get(), textAndSuffix.c_str(), fgColor.sdlColor()));
-                    break;
-                case RenderStyle::Shaded:
-                    surface.reset(
-                            TTF_RenderUTF8_Shaded(mFont.get(), textAndSuffix.c_str(), fgColor.sdlColor(),
-                                                  mVisualMetrics.background.sdlColor()));
-                    break;
-                case RenderStyle::Solid:
-                    surface.reset(TTF_RenderUTF8_Solid(mFont.get(), textAndSuffix.c_str(), fgColor.sdlColor()));
-                    break;
-            }
-            if (surface) {
-                mTextSize = Size{surface->w, surface->h};
-                mTexture.reset(SDL_CreateTextureFromSurface(context.get(), surface.get()));
-                if (!mTexture)
-                    throw TextGadgetException( fmt::format("Texture error: {}", SDL_GetError()));
-            } else {
-                throw TextGadgetException( fmt::format("Surface error: {}", SDL_GetError()));
-            }
+            int w, h;
+            if (TTF_SizeUTF8(mFont.get(), mText.c_str(), &w, &h))
+                throw TextGadgetException( fmt::format("Measure error: {}", SDL_GetError()));
+            mTextSize = Size{w, h};
         } else {
             throw TextGadgetException( fmt::format("Font error"));
         }
@@ -66,13 +190,12 @@ namespace rose {
         setNeedsDrawing();
         setNeedsLayout();
         mTextRenderRequired = true;
-        mTexture.reset();
     }
 
     bool TextGadget::initialLayout(Context &context) {
         if (!mText.empty()) {
             try {
-               createTexture(context);
+                measureText();
                 mVisualMetrics.desiredSize = mTextSize;
             } catch (TextGadgetException &e) {
                 fmt::print("{}\n", e.what());
@@ -85,9 +208,35 @@ namespace rose {
 
     void TextGadget::draw(Context &context, Point drawLocation) {
         Gadget::draw(context, drawLocation);
+        Rectangle textRenderRect = mVisualMetrics.renderRect + drawLocation;
+        if (auto bitmap = bitmapFont(); bitmap) {
+            // Glyphs are copied straight from the strip, there is no Texture to render.
+            mTextRenderRequired = false;
+            mTexture.reset();
+            if (!mText.empty() && context.isVisible(textRenderRect)) {
+                try {
+                    auto strip = sheetTexture(context, bitmap->name(), bitmap->strip());
+                    bitmap->render(context, *strip, mText, textRenderRect.point, mTextFgColor);
+                } catch (const SurfaceRuntimeError &e) {
+                    fmt::print("{}\n", e.what());
+                }
+            }
+            return;
+        }
+        if (mTextRenderRequired && mText.empty()) {
+            mTextRenderRequired = false;
+            mTexture.reset();
+        } else if (mTextRenderRequired && context.isVisible(textRenderRect)) {
+            try {
+                requestTexture(context, mText);
+            } catch (TextGadgetException &e) {
+                fmt::print("{}\n", e.what());
+            }
+        }
         if (mTexture) {
-            Rectangle textRenderRect = mVisualMetrics.renderRect + drawLocation;
-            context.renderCopy(mTexture, textRenderRect);
+            if (!isColorBaked())
+                mTexture->setColorMod(mTextFgColor);
+            context.renderCopy(*mTexture, Rectangle{textRenderRect.point, mTexture->getSize()});
         }
     }
 
@@ -98,55 +247,125 @@ namespace rose {
     IconGadget::IconGadget(std::shared_ptr<Theme> &theme) : TextGadget(theme) {
         mFontName = theme->iconFontName;
         mPointSize = theme->iconPointSize;
+        mRenderStyle = RenderStyle::Blended;
     }
 
 #if 1
+    void IconGadget::InitializeIconSheet(const std::filesystem::path &basePath) {
+        try {
+            mIconSheet = std::make_unique<IconSheet>(basePath);
+        } catch (const IconSheetException &e) {
+            fmt::print("{}\n", e.what());
+            mIconSheet.reset();
+        }
+    }
+
+    const IconSheet::Entry *IconGadget::sheetEntry(uint32_t code) const {
+        if (mIconSheet && mIconSheet->pointSize() == mPointSize)
+            return mIconSheet->find(code);
+        return nullptr;
+    }
+
+    std::shared_ptr<MappedFile> IconGadget::fontFile() {
+        return mMaterial ? mMaterial->fontFile() : nullptr;
+    }
+
     void IconGadget::createIconTexture(Context &context) {
         if (!mFont) {
             mFont = mMaterial->getFont(mPointSize);
         }
 
+        mTextRenderRequired = false;
         mTextSize = Size();
 
         auto utf8Data = utf8(mIconCode);
-        Surface surface{TTF_RenderUTF8_Blended(mFont.get(), reinterpret_cast<const char *>(utf8Data.data()),
-                                               mTextFgColor.sdlColor())};
-
-        int minX = surface->w;
-        int minY = surface->h;
-        int maxX = 0, maxY = 0;
-
-        for (auto y = 0; y < surface->h; ++y) {
-            for (auto x = 0; x < surface->w; ++x) {
-                auto rgba = Color::toColor(surface->format, surface.pixel(x, y));
-                if (rgba[Color::ALPHA] > 0.f) {
-                    minX = std::min(minX, x);
-                    minY = std::min(minY, y);
-                    maxX = std::max(maxX, x);
-                    maxY = std::max(maxY, y);
-                }
+        std::string glyph{reinterpret_cast<const char *>(utf8Data.data())};
+        TextTextureKey key{context.get(), mFontName, mPointSize, RenderStyle::Blended,
+                           TextTextureKey::pack(color::OpaqueWhite), 0u, glyph};
+
+        auto cache = textureCache();
+        if (cache) {
+            if (auto texture = cache->findText(key); texture) {
+                mTexture = texture;
+                mTextSize = mTexture->getSize();
+                return;
             }
         }
 
+        Surface surface{TTF_RenderUTF8_Blended(mFont.get(), glyph.c_str(), color::OpaqueWhite.sdlColor())};
+        if (!surface)
+            throw TextGadgetException( fmt::format("Surface error: {}", SDL_GetError()));
+
 #ifdef MINIMIZE_ENTYPO
-        Surface minimal{maxX - minX + 1, maxY - minY + 1};
-        for (auto y = 0; y < minimal->h; ++y) {
-            for (auto x = 0; x < minimal->w; ++x) {
-                auto rgba = Color::toColor(surface->format, surface.pixel(minX + x, minY + y));
-                minimal.pixel(x, y) = Color::mapSdl(minimal->format, rgba);
+        auto bounds = surface.alphaBounds();
+        if (!bounds.size.w || !bounds.size.h)
+            bounds = Rectangle{0, 0, surface->w, surface->h};
+        mTrimSizes[trimKey()] = bounds.size;
+
+        Surface minimal{bounds.size.w, bounds.size.h, 32, SDL_PIXELFORMAT_ARGB8888};
+        SDL_SetSurfaceBlendMode(surface.get(), SDL_BLENDMODE_NONE);
+        SDL_Rect src{bounds.point.x, bounds.point.y, bounds.size.w, bounds.size.h};
+        SDL_BlitSurface(surface.get(), &src, minimal.get(), nullptr);
+        auto texture = minimal.toTexture(context);
+#else
+        auto texture = surface.toTexture(context);
+#endif
+        mTexture = cache ? cache->insertText(key, std::move(texture)) : std::make_shared<Texture>(std::move(texture));
+        mTextSize = mTexture->getSize();
+    }
+
+    void IconGadget::setIcon(uint32_t icon) {
+        if (mIconCode == icon)
+            return;
+
+        [[maybe_unused]] auto previous = mIconCode;
+        mIconCode = icon;
+#ifndef MINIMIZE_ENTYPO
+        // An icon of the same size takes the same space, only the rectangle drawn changes.
+        if (previous && !mTextRenderRequired) {
+            auto from = sheetEntry(previous);
+            auto to = sheetEntry(icon);
+            bool sameSize = from && to ? from->w == to->w && from->h == to->h :
+                            !from && !to && mFont &&
+                            getGlyphMetrics32(mFont, previous).advance == getGlyphMetrics32(mFont, icon).advance;
+            if (sameSize) {
+                setNeedsDrawing();
+                return;
             }
         }
-        mTexture = minimal.toTexture(context);
-#else
-        mTexture = surface.toTexture(context);
 #endif
-        mTextSize = mTexture.getSize();
+        textUpdated();
+    }
+
+    void IconGadget::measureIcon() {
+        if (auto entry = sheetEntry(mIconCode); entry) {
+            mTextSize = Size{entry->w, entry->h};
+            return;
+        }
+
+        if (!mFont) {
+            mFont = mMaterial->getFont(mPointSize);
+        }
+
+        auto utf8Data = utf8(mIconCode);
+        int w, h;
+        if (TTF_SizeUTF8(mFont.get(), reinterpret_cast<const char *>(utf8Data.data()), &w, &h))
+            throw TextGadgetException( fmt::format("Measure error: {}", SDL_GetError()));
+        mTextSize = Size{w, h};
     }
 
     bool IconGadget::initialLayout(Context &context) {
         if (mIconCode) {
             try {
-                createIconTexture(context);
+#ifdef MINIMIZE_ENTYPO
+                // The trimmed size is only known once the glyph has been rendered.
+                if (auto found = mTrimSizes.find(trimKey()); found != mTrimSizes.end())
+                    mTextSize = found->second;
+                else
+                    createIconTexture(context);
+#else
+                measureIcon();
+#endif
                 mVisualMetrics.desiredSize = mTextSize;
             } catch (TextGadgetException &e) {
                 fmt::print("{}\n", e.what());
@@ -158,9 +377,58 @@ namespace rose {
     }
 
     void IconGadget::draw(Context &context, Point drawLocation) {
-        if (!mTexture)
-            createIconTexture(context);
-        TextGadget::draw(context, drawLocation);
+        Gadget::draw(context, drawLocation);
+        Rectangle iconRenderRect = mVisualMetrics.renderRect + drawLocation;
+#ifdef MINIMIZE_ENTYPO
+        if (mTextRenderRequired && !mIconCode) {
+            mTextRenderRequired = false;
+            mTexture.reset();
+        } else if (mTextRenderRequired && context.isVisible(iconRenderRect)) {
+            try {
+                // The trimmed glyph is produced by createIconTexture() on the UI thread.
+                createIconTexture(context);
+            } catch (TextGadgetException &e) {
+                fmt::print("{}\n", e.what());
+            }
+        }
+        if (mTexture) {
+            mTexture->setColorMod(mTextFgColor);
+            context.renderCopy(*mTexture, Rectangle{iconRenderRect.point, mTexture->getSize()});
+        }
+#else
+        mTextRenderRequired = false;
+        if (!mIconCode || !context.isVisible(iconRenderRect))
+            return;
+
+        if (auto entry = sheetEntry(mIconCode); entry) {
+            try {
+                auto sheet = sheetTexture(context, mIconSheet->name(), mIconSheet->sheet());
+                mIconSheet->render(context, *sheet, *entry, iconRenderRect.point, mTextFgColor);
+            } catch (const SurfaceRuntimeError &e) {
+                fmt::print("{}\n", e.what());
+            }
+            return;
+        }
+
+        if (!mMaterial)
+            return;
+
+        if (!mFont)
+            mFont = mMaterial->getFont(mPointSize);
+        if (!mFont)
+            return;
+
+        if (!mAtlas || mAtlas->font() != mFont) {
+            if (auto cache = textureCache(); cache)
+                mAtlas = cache->glyphAtlas(context, mFontName, mPointSize, mFont);
+            else
+                mAtlas = std::make_shared<GlyphAtlas>(mFont);
+            mFont = mAtlas->font();
+        }
+
+        if (auto glyph = mAtlas->glyph(context, mIconCode); glyph)
+            mAtlas->render(context, *glyph, Rectangle{iconRenderRect.point, glyph->rect.size}, mTextFgColor);
+#endif
     }
 
     void IconGadget::initialize() {
@@ -0,0 +1,63 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * TextRasterizer.cpp Created by Richard Buckley (C) 18/10/26
+ */
+
+#include "TextRasterizer.h"
+
+namespace rose {
+
+    namespace {
+        /**
+         * @struct ThreadFonts
+         * @brief The fonts opened by one thread, keyed by file mapping and point size.
+         */
+        struct ThreadFonts {
+            static constexpr std::size_t Budget = 16;   ///< Fonts kept open by a thread.
+
+            std::map<std::pair<const MappedFile*, int>, FontPointer> fonts{};
+
+            FontPointer get(const std::shared_ptr<MappedFile> &fontFile, int pointSize) {
+                auto key = std::make_pair(static_cast<const MappedFile*>(fontFile.get()), pointSize);
+                if (auto found = fonts.find(key); found != fonts.end())
+                    return found->second;
+
+                if (fonts.size() >= Budget)
+                    fonts.clear();
+                auto font = openMappedFont(fontFile, pointSize);
+                if (font)
+                    fonts.emplace(key, font);
+                return font;
+            }
+        };
+
+        thread_local ThreadFonts threadFonts{};
+    }
+
+    Surface rasterizeText(const TextRasterRequest &request) {
+        Surface surface{};
+        auto font = threadFonts.get(request.fontFile, request.pointSize);
+        if (!font || request.text.empty())
+            return surface;
+
+        switch (request.renderStyle) {
+            case RenderStyle::Blended:
+                surface.reset(TTF_RenderUTF8_Blended(font.get(), request.text.c_str(), request.foreground.sdlColor()));
+                break;
+            case RenderStyle::Shaded:
+                surface.reset(TTF_RenderUTF8_Shaded(font.get(), request.text.c_str(), request.foreground.sdlColor(),
+                                                    request.background.sdlColor()));
+                break;
+            case RenderStyle::Solid:
+                surface.reset(TTF_RenderUTF8_Solid(font.get(), request.text.c_str(), request.foreground.sdlColor()));
+                break;
+        }
+        if (!surface)
+            fmt::print("Surface error: {}\n", SDL_GetError());
+        return surface;
+    }
+
+} // rose
@@ -0,0 +1,71 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * TextureCache.cpp Created by Richard Buckley (C) 18/10/26
+ */
+
+#include "TextureCache.h"
+
+namespace rose {
+
+    std::size_t TextTextureKeyHash::operator()(const TextTextureKey &key) const noexcept {
+        auto combine = [](std::size_t seed, std::size_t value) {
+            return seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6u) + (seed >> 2u));
+        };
+
+        auto seed = std::hash<std::string>{}(key.text);
+        seed = combine(seed, std::hash<std::string>{}(key.fontName));
+        seed = combine(seed, std::hash<const void *>{}(key.renderer));
+        seed = combine(seed, std::hash<int>{}(key.pointSize));
+        seed = combine(seed, std::hash<int>{}(static_cast<int>(key.renderStyle)));
+        seed = combine(seed, std::hash<uint32_t>{}(key.foreground));
+        return combine(seed, std::hash<uint32_t>{}(key.background));
+    }
+
+    SharedTexture TextureCache::insertText(const TextTextureKey &key, Texture &&texture) {
+        auto size = texture.getSize();
+        auto cost = static_cast<std::size_t>(size.w) * static_cast<std::size_t>(size.h) * 4;
+        return mTextCache.insert(key, std::make_shared<Texture>(std::move(texture)), cost);
+    }
+
+    std::size_t GlyphAtlasKeyHash::operator()(const GlyphAtlasKey &key) const noexcept {
+        auto seed = std::hash<std::string>{}(key.fontName);
+        seed ^= std::hash<const void *>{}(key.renderer) + 0x9e3779b97f4a7c15ULL + (seed << 6u) + (seed >> 2u);
+        return seed ^ (std::hash<int>{}(key.pointSize) + 0x9e3779b97f4a7c15ULL + (seed << 6u) + (seed >> 2u));
+    }
+
+    std::shared_ptr<GlyphAtlas> TextureCache::glyphAtlas(Context &context, const std::string &fontName, int pointSize,
+                                                         const FontPointer &font) {
+        GlyphAtlasKey key{context.get(), fontName, pointSize};
+        if (auto found = mGlyphAtlases.find(key); found)
+            return found;
+        return mGlyphAtlases.insert(key, std::make_shared<GlyphAtlas>(font), 1);
+    }
+
+    std::size_t SheetTextureKeyHash::operator()(const SheetTextureKey &key) const noexcept {
+        auto seed = std::hash<std::string>{}(key.name);
+        return seed ^ (std::hash<const void *>{}(key.renderer) + 0x9e3779b97f4a7c15ULL + (seed << 6u) + (seed >> 2u));
+    }
+
+    SharedTexture TextureCache::sheetTexture(Context &context, const std::string &name, Surface &sheet) {
+        SheetTextureKey key{context.get(), name};
+        if (auto found = mSheets.find(key); found != mSheets.end())
+            return found->second;
+        auto texture = std::make_shared<Texture>(sheet.toTexture(context));
+        texture->setBlendMode(SDL_BLENDMODE_BLEND);
+        return mSheets.emplace(std::move(key), std::move(texture)).first->second;
+    }
+
+    void TextureCache::purgeRenderer(SDL_Renderer *renderer) {
+        mTextCache.eraseIf([renderer](const TextTextureKey &key, const SharedTexture &) {
+            return key.renderer == renderer;
+        });
+        mGlyphAtlases.eraseIf([renderer](const GlyphAtlasKey &key, const std::shared_ptr<GlyphAtlas> &) {
+            return key.renderer == renderer;
+        });
+        std::erase_if(mSheets, [renderer](const auto &entry) { return entry.first.renderer == renderer; });
+    }
+
+} // rose
@@ -0,0 +1,162 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * TilePyramid.cpp Created by Richard Buckley (C) 18/10/26
+ */
+
+#include "TilePyramid.h"
+#include "ImageDecode.h"
+#include "XDGBaseDir.h"
+#include <SDL_image.h>
+#include <fstream>
+#include <thread>
+
+namespace rose {
+
+    namespace {
+        std::filesystem::path tilePath(const std::filesystem::path &directory, const TileKey &key) {
+            return directory / fmt::format("{}-{}-{}.png", key.level, key.column, key.row);
+        }
+
+        /**
+         * @brief A name to write to before renaming, so readers never see a partly written file.
+         */
+        std::filesystem::path temporaryPath(const std::filesystem::path &path) {
+            return std::filesystem::path{fmt::format("{}.{}.tmp", path.string(),
+                                                     std::hash<std::thread::id>{}(std::this_thread::get_id()))};
+        }
+    }
+
+    bool TilePyramid::locate() {
+        auto key = fileCacheKey(mSource);
+        if (!key)
+            return false;
+        std::error_code ec{};
+        auto absolute = std::filesystem::absolute(mSource, ec);
+        if (ec)
+            return false;
+        if (mCacheRoot.empty())
+            mCacheRoot = roseCacheDirectory("tiles");
+        mSourceDirectory = mCacheRoot / fmt::format("{:016x}", fnv1a(absolute.string()));
+        mDirectory = mSourceDirectory / key.value();
+        return true;
+    }
+
+    void TilePyramid::pruneVersions() {
+        std::error_code ec{};
+        for (const auto &entry : std::filesystem::directory_iterator{mSourceDirectory, ec}) {
+            if (entry.path() != mDirectory && entry.is_directory(ec)) {
+                std::filesystem::remove_all(entry.path(), ec);
+                if (ec)
+                    fmt::print("Can not remove '{}': {}\n", entry.path().string(), ec.message());
+            }
+        }
+    }
+
+    bool TilePyramid::load() {
+        if (!locate())
+            return false;
+
+        std::ifstream manifest{mDirectory / ManifestName};
+        std::string version{};
+        if (!manifest || !std::getline(manifest, version) || version != ManifestVersion)
+            return false;
+
+        int width{}, height{}, levels{};
+        if (!(manifest >> width >> height >> levels) || width <= 0 || height <= 0 || levels <= 0)
+            return false;
+
+        mSize = Size{width, height};
+        mLevels = levels;
+        return true;
+    }
+
+    void TilePyramid::build() {
+        if (!locate())
+            throw TilePyramidError(fmt::format("Image file not found: {}", mSource.string()));
+
+        std::error_code ec{};
+        std::filesystem::create_directories(mDirectory, ec);
+        if (ec)
+            throw TilePyramidError(fmt::format("Can not create '{}': {}", mDirectory.string(), ec.message()));
+
+        Surface image{IMG_Load(mSource.c_str())};
+        if (!image)
+            throw TilePyramidError(fmt::format("Can not decode '{}': {}", mSource.string(), SDL_GetError()));
+        SDL_SetSurfaceBlendMode(image.get(), SDL_BLENDMODE_NONE);
+
+        mSize = Size{image->w, image->h};
+        int level = 0;
+        while (true) {
+            for (int row = 0; row * TileSize < image->h; ++row) {
+                for (int column = 0; column * TileSize < image->w; ++column) {
+                    TileKey key{level, column, row};
+                    SDL_Rect src{column * TileSize, row * TileSize, std::min(TileSize, image->w - column * TileSize),
+                                 std::min(TileSize, image->h - row * TileSize)};
+                    Surface tile{SDL_CreateRGBSurfaceWithFormat(0, src.w, src.h, 32, SDL_PIXELFORMAT_ARGB8888)};
+                    if (!tile || SDL_BlitSurface(image.get(), &src, tile.get(), nullptr))
+                        throw TilePyramidError(fmt::format("Can not cut tile: {}", SDL_GetError()));
+
+                    auto path = tilePath(mDirectory, key);
+                    auto temporary = temporaryPath(path);
+                    if (IMG_SavePNG(tile.get(), temporary.c_str()))
+                        throw TilePyramidError(fmt::format("Can not write '{}': {}", path.string(), SDL_GetError()));
+                    std::filesystem::rename(temporary, path, ec);
+                    if (ec)
+                        throw TilePyramidError(fmt::format("Can not write '{}': {}", path.string(), ec.message()));
+                }
+            }
+
+            ++level;
+            if (image->w <= TileSize && image->h <= TileSize)
+                break;
+
+            // Each level replaces the last, so at most one and a quarter images are held.
+            image = halveImage(image);
+            if (!image)
+                throw TilePyramidError(fmt::format("Can not reduce '{}': {}", mSource.string(), SDL_GetError()));
+            SDL_SetSurfaceBlendMode(image.get(), SDL_BLENDMODE_NONE);
+        }
+
+        auto manifestPath = mDirectory / ManifestName;
+        auto temporary = temporaryPath(manifestPath);
+        {
+            std::ofstream manifest{temporary};
+            manifest << ManifestVersion << '\n' << mSize.w << ' ' << mSize.h << ' ' << level << '\n';
+            if (!manifest)
+                throw TilePyramidError(fmt::format("Can not write '{}'", manifestPath.string()));
+        }
+        std::filesystem::rename(temporary, manifestPath, ec);
+        if (ec)
+            throw TilePyramidError(fmt::format("Can not write '{}': {}", manifestPath.string(), ec.message()));
+        mLevels = level;
+        pruneVersions();
+    }
+
+    Size TilePyramid::levelSize(int level) const {
+        // The same rounding as halveImage().
+        auto size = mSize;
+        for (int i = 0; i < level; ++i)
+            size = Size{std::max(size.w / 2, 1), std::max(size.h / 2, 1)};
+        return size;
+    }
+
+    Size TilePyramid::tileGrid(int level) const {
+        auto size = levelSize(level);
+        return Size{(size.w + TileSize - 1) / TileSize, (size.h + TileSize - 1) / TileSize};
+    }
+
+    Rectangle TilePyramid::tileRectangle(const TileKey &key) const {
+        auto size = levelSize(key.level);
+        auto x = key.column * TileSize;
+        auto y = key.row * TileSize;
+        return Rectangle{x, y, std::min(TileSize, size.w - x), std::min(TileSize, size.h - y)};
+    }
+
+    Surface TilePyramid::loadTile(const TileKey &key) const {
+        return Surface{IMG_Load(tilePath(mDirectory, key).c_str())};
+    }
+
+} // rose
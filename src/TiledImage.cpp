@@ -0,0 +1,330 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * TiledImage.cpp Created by Richard Buckley (C) 18/10/26
+ */
+
+#include "TiledImage.h"
+#include <Application.h>
+#include <ImageDecode.h>
+#include <cmath>
+
+namespace rose {
+
+    void TiledImage::setFilePath(const std::filesystem::path &path) {
+        if (mImageFilePath != path) {
+            mImageFilePath = path;
+            mPyramid.reset();
+            mPyramidRequested = false;
+            ++mGeneration;
+            mTiles.clear();
+            mLoading.clear();
+            mFailed.clear();
+            mScale = 0.;
+            setNeedsLayout();
+            setNeedsDrawing();
+        }
+    }
+
+    void TiledImage::requestPyramid() {
+        auto application = getApplicationPtr();
+        if (mPyramidRequested || mImageFilePath.empty() || !application)
+            return;
+        mPyramidRequested = true;
+
+        std::weak_ptr<Gadget> weak = shared_from_this();
+        auto generation = mGeneration;
+        application->workerPool().submit([weak, path = mImageFilePath, generation]() -> WorkerPool::Completion {
+            auto pyramid = std::make_shared<TilePyramid>(path);
+            std::string error{};
+            try {
+                if (!pyramid->load())
+                    pyramid->build();
+            } catch (const std::exception &e) {
+                error = e.what();
+            }
+            return [weak, pyramid, error, generation]() {
+                if (auto image = std::dynamic_pointer_cast<TiledImage>(weak.lock()); image)
+                    image->pyramidReady(pyramid, error, generation);
+            };
+        });
+    }
+
+    void TiledImage::pyramidReady(const std::shared_ptr<TilePyramid> &pyramid, const std::string &error,
+                                  uint64_t generation) {
+        if (generation != mGeneration)
+            return;
+        if (!error.empty()) {
+            fmt::print("{}\n", error);
+            return;
+        }
+        mPyramid = pyramid;
+        setNeedsDrawing();
+    }
+
+    void TiledImage::requestTile(const TileKey &key) {
+        auto application = getApplicationPtr();
+        if (!application || mLoading.size() >= MaxTileLoads || mLoading.contains(key) || mFailed.contains(key))
+            return;
+        mLoading.insert(key);
+
+        std::weak_ptr<Gadget> weak = shared_from_this();
+        auto generation = mGeneration;
+        application->workerPool().submit([weak, pyramid = mPyramid, key, generation]() -> WorkerPool::Completion {
+            auto surface = std::make_shared<Surface>(pyramid->loadTile(key));
+            return [weak, key, surface, generation]() {
+                if (auto image = std::dynamic_pointer_cast<TiledImage>(weak.lock()); image)
+                    image->tileReady(key, *surface, generation);
+            };
+        });
+    }
+
+    void TiledImage::tileReady(const TileKey &key, Surface &surface, uint64_t generation) {
+        auto window = getWindow();
+        if (generation != mGeneration || !window)
+            return;
+        mLoading.erase(key);
+
+        if (!surface) {
+            fmt::print("Tile {} {},{} of {} could not be loaded: {}\n", key.level, key.column, key.row,
+                       mImageFilePath.string(), SDL_GetError());
+            mFailed.insert(key);
+            return;
+        }
+
+        auto texture = surface.toTexture(window->context());
+        if (!texture) {
+            mFailed.insert(key);
+            return;
+        }
+        auto cost = static_cast<std::size_t>(surface->w) * static_cast<std::size_t>(surface->h) * 4;
+        mTiles.insert(key, std::make_shared<Texture>(std::move(texture)), cost);
+        setNeedsDrawing();
+    }
+
+    double TiledImage::fitScale() const {
+        if (!mPyramid || !mViewSize)
+            return 1.;
+        auto size = mPyramid->size();
+        return std::min(static_cast<double>(mViewSize.w) / size.w, static_cast<double>(mViewSize.h) / size.h);
+    }
+
+    int TiledImage::levelForScale() const {
+        if (mScale >= 1.)
+            return 0;
+        auto level = static_cast<int>(std::floor(std::log2(1. / mScale)));
+        return std::clamp(level, 0, mPyramid->levels() - 1);
+    }
+
+    void TiledImage::clampView() {
+        if (!mPyramid || mScale <= 0.)
+            return;
+        auto size = mPyramid->size();
+        auto clampAxis = [](double &view, double visible, int extent) {
+            if (visible >= extent)
+                view = (extent - visible) / 2.;
+            else
+                view = std::clamp(view, 0., extent - visible);
+        };
+        clampAxis(mViewX, mViewSize.w / mScale, size.w);
+        clampAxis(mViewY, mViewSize.h / mScale, size.h);
+    }
+
+    void TiledImage::pan(double dx, double dy) {
+        if (!mPyramid || mScale <= 0.)
+            return;
+        mViewX -= dx / mScale;
+        mViewY -= dy / mScale;
+        clampView();
+        setNeedsDrawing();
+    }
+
+    void TiledImage::zoomAbout(double x, double y, double factor) {
+        if (!mPyramid || mScale <= 0.)
+            return;
+        auto imageX = mViewX + x / mScale;
+        auto imageY = mViewY + y / mScale;
+        auto scale = std::clamp(mScale * factor, std::min(fitScale(), MaxScale), MaxScale);
+        if (scale == mScale)
+            return;
+        mScale = scale;
+        mViewX = imageX - x / mScale;
+        mViewY = imageY - y / mScale;
+        clampView();
+        setNeedsDrawing();
+    }
+
+    void TiledImage::drawTile(Context &context, const Rectangle &view, const TileKey &key) {
+        auto levelSize = mPyramid->levelSize(key.level);
+        auto size = mPyramid->size();
+        // Screen pixels per level pixel, the level sizes are rounded so each axis is computed.
+        auto scaleX = mScale * size.w / levelSize.w;
+        auto scaleY = mScale * size.h / levelSize.h;
+        auto originX = mViewX * levelSize.w / size.w;
+        auto originY = mViewY * levelSize.h / size.h;
+
+        // Tile edges are rounded independently so adjacent tiles meet without gaps.
+        auto tile = mPyramid->tileRectangle(key);
+        auto left = static_cast<int>(std::lround((tile.point.x - originX) * scaleX));
+        auto top = static_cast<int>(std::lround((tile.point.y - originY) * scaleY));
+        auto right = static_cast<int>(std::lround((tile.point.x + tile.size.w - originX) * scaleX));
+        auto bottom = static_cast<int>(std::lround((tile.point.y + tile.size.h - originY) * scaleY));
+        Rectangle dst{view.point.x + left, view.point.y + top, right - left, bottom - top};
+
+        if (auto texture = mTiles.find(key); texture) {
+            context.renderCopy(*texture, dst);
+            return;
+        }
+        requestTile(key);
+
+        for (int level = key.level + 1; level < mPyramid->levels(); ++level) {
+            auto shift = level - key.level;
+            TileKey parent{level, key.column >> shift, key.row >> shift};
+            if (auto texture = mTiles.find(parent); texture) {
+                auto parentTile = mPyramid->tileRectangle(parent);
+                Rectangle src{(tile.point.x >> shift) - parentTile.point.x, (tile.point.y >> shift) - parentTile.point.y,
+                              std::max(tile.size.w >> shift, 1), std::max(tile.size.h >> shift, 1)};
+                src.size.w = std::min(src.size.w, parentTile.size.w - src.point.x);
+                src.size.h = std::min(src.size.h, parentTile.size.h - src.point.y);
+                if (src.size.w > 0 && src.size.h > 0) {
+                    context.renderCopy(*texture, src, dst);
+                    return;
+                }
+            }
+        }
+
+        if (mPlaceholderColor)
+            context.fillRect(dst, mPlaceholderColor);
+    }
+
+    bool TiledImage::initialLayout(Context &context) {
+        if (!mVisualMetrics.desiredSize && !mImageFilePath.empty()) {
+            auto size = imageFileSize(mImageFilePath).value_or(DefaultViewSize);
+            mVisualMetrics.desiredSize = Size{std::min(size.w, DefaultViewSize.w), std::min(size.h, DefaultViewSize.h)};
+        }
+        return Gadget::initialLayout(context);
+    }
+
+    void TiledImage::draw(Context &context, Point drawLocation) {
+        Gadget::draw(context, drawLocation);
+        auto view = mVisualMetrics.renderRect + drawLocation;
+        if (!context.isVisible(view))
+            return;
+
+        if (!mPyramid) {
+            requestPyramid();
+            if (mPlaceholderColor)
+                context.fillRect(view, mPlaceholderColor);
+            return;
+        }
+
+        if (mViewSize != view.size || mScale <= 0.) {
+            mViewSize = view.size;
+            if (mScale <= 0.)
+                mScale = fitScale();
+            clampView();
+        }
+
+        ClipRectangleGuard clipRectangleGuard{context, view};
+        auto level = levelForScale();
+        auto levelSize = mPyramid->levelSize(level);
+        auto size = mPyramid->size();
+        auto grid = mPyramid->tileGrid(level);
+
+        // The visible part of the level, in level pixels.
+        auto left = mViewX * levelSize.w / size.w;
+        auto top = mViewY * levelSize.h / size.h;
+        auto right = (mViewX + mViewSize.w / mScale) * levelSize.w / size.w;
+        auto bottom = (mViewY + mViewSize.h / mScale) * levelSize.h / size.h;
+
+        auto firstColumn = std::max(0, static_cast<int>(std::floor(left / TilePyramid::TileSize)));
+        auto lastColumn = std::min(grid.w - 1, static_cast<int>(std::floor(right / TilePyramid::TileSize)));
+        auto firstRow = std::max(0, static_cast<int>(std::floor(top / TilePyramid::TileSize)));
+        auto lastRow = std::min(grid.h - 1, static_cast<int>(std::floor(bottom / TilePyramid::TileSize)));
+
+        if (mPlaceholderColor && (left < 0. || top < 0. || right > levelSize.w || bottom > levelSize.h))
+            context.fillRect(view, mPlaceholderColor);
+
+        for (int row = firstRow; row <= lastRow; ++row)
+            for (int column = firstColumn; column <= lastColumn; ++column)
+                drawTile(context, view, TileKey{level, column, row});
+    }
+
+    bool TiledImage::mouseButtonEvent(const SDL_MouseButtonEvent &e) {
+        // Touches are handled as touches, not as the mouse events SDL makes from them.
+        if (e.which == SDL_TOUCH_MOUSEID)
+            return true;
+        if (e.button == SDL_BUTTON_LEFT) {
+            mDragging = e.type == SDL_MOUSEBUTTONDOWN;
+            return true;
+        }
+        return Gadget::mouseButtonEvent(e);
+    }
+
+    bool TiledImage::mouseMotionEvent(const SDL_MouseMotionEvent &e) {
+        if (e.which == SDL_TOUCH_MOUSEID)
+            return true;
+        if (mDragging && (e.state & SDL_BUTTON_LMASK)) {
+            pan(e.xrel, e.yrel);
+            return true;
+        }
+        return Gadget::mouseMotionEvent(e);
+    }
+
+    bool TiledImage::mouseWheelEvent(const SDL_MouseWheelEvent &e) {
+        if (!mPyramid)
+            return Gadget::mouseWheelEvent(e);
+
+        auto steps = e.direction == SDL_MOUSEWHEEL_FLIPPED ? -e.y : e.y;
+        int x{}, y{};
+        SDL_GetMouseState(&x, &y);
+        auto view = mVisualMetrics.renderRect + mVisualMetrics.lastDrawLocation;
+        zoomAbout(x - view.point.x, y - view.point.y, std::pow(WheelZoomStep, steps));
+        return true;
+    }
+
+    bool TiledImage::fingerTouchEvent(const SDL_TouchFingerEvent &e) {
+        auto window = getWindow();
+        if (!window)
+            return false;
+
+        int width{}, height{};
+        SDL_GetWindowSize(window->sdlWindow().get(), &width, &height);
+        std::pair<double,double> position{static_cast<double>(e.x) * width, static_cast<double>(e.y) * height};
+
+        switch (e.type) {
+            case SDL_FINGERDOWN:
+                mFingers[e.fingerId] = position;
+                break;
+            case SDL_FINGERUP:
+                mFingers.erase(e.fingerId);
+                break;
+            case SDL_FINGERMOTION:
+                if (auto finger = mFingers.find(e.fingerId); finger != mFingers.end()) {
+                    auto previous = finger->second;
+                    finger->second = position;
+                    if (mFingers.size() == 1) {
+                        pan(position.first - previous.first, position.second - previous.second);
+                    } else if (mFingers.size() == 2) {
+                        // Pinch about the point between the fingers, and move with it.
+                        auto other = mFingers.begin()->first == e.fingerId ? std::next(mFingers.begin())->second
+                                                                           : mFingers.begin()->second;
+                        auto before = std::hypot(previous.first - other.first, previous.second - other.second);
+                        auto after = std::hypot(position.first - other.first, position.second - other.second);
+                        auto view = mVisualMetrics.renderRect + mVisualMetrics.lastDrawLocation;
+                        pan((position.first - previous.first) / 2., (position.second - previous.second) / 2.);
+                        if (before > 1.)
+                            zoomAbout((position.first + other.first) / 2. - view.point.x,
+                                      (position.second + other.second) / 2. - view.point.y, after / before);
+                    }
+                }
+                break;
+            default:
+                break;
+        }
+        return true;
+    }
+
+} // rose
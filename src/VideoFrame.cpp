@@ -0,0 +1,179 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * VideoFrame.cpp Created by Richard Buckley (C) 18/10/26
+ */
+
+#include "VideoFrame.h"
+#include <Application.h>
+#include <algorithm>
+#include <chrono>
+#include <fmt/format.h>
+
+namespace rose {
+
+    YuvFrame::YuvFrame(SDL_PixelFormatEnum frameFormat, Size frameSize) : format(frameFormat), size(frameSize) {
+        if (format != SDL_PIXELFORMAT_IYUV && format != SDL_PIXELFORMAT_NV12)
+            throw VideoFrameError(fmt::format("Unsupported video frame format {}", static_cast<int>(format)));
+
+        auto chromaWidth = (size.w + 1) / 2;
+        pitch[0] = size.w;
+        if (format == SDL_PIXELFORMAT_NV12) {
+            pitch[1] = chromaWidth * 2;
+        } else {
+            pitch[1] = chromaWidth;
+            pitch[2] = chromaWidth;
+        }
+
+        std::size_t total = 0;
+        for (int p = 0; p < planes(); ++p) {
+            offset[static_cast<std::size_t>(p)] = total;
+            total += static_cast<std::size_t>(pitch[static_cast<std::size_t>(p)]) * static_cast<std::size_t>(rows(p));
+        }
+        data.resize(total);
+    }
+
+    FrameMailbox::~FrameMailbox() {
+        delete mLatest.exchange(nullptr);
+        delete mRecycle.exchange(nullptr);
+    }
+
+    void FrameMailbox::putRecycle(std::unique_ptr<YuvFrame> frame) {
+        delete mRecycle.exchange(frame.release(), std::memory_order_acq_rel);
+    }
+
+    std::unique_ptr<YuvFrame> FrameMailbox::acquire(SDL_PixelFormatEnum format, Size size) {
+        std::unique_ptr<YuvFrame> frame{mRecycle.exchange(nullptr, std::memory_order_acq_rel)};
+        if (frame && frame->format == format && frame->size == size)
+            return frame;
+        return std::make_unique<YuvFrame>(format, size);
+    }
+
+    void FrameMailbox::post(std::unique_ptr<YuvFrame> frame) {
+        std::unique_ptr<YuvFrame> stale{mLatest.exchange(frame.release(), std::memory_order_acq_rel)};
+        if (stale) {
+            mDropped.fetch_add(1, std::memory_order_relaxed);
+            putRecycle(std::move(stale));
+        }
+    }
+
+    std::unique_ptr<YuvFrame> FrameMailbox::take() {
+        return std::unique_ptr<YuvFrame>{mLatest.exchange(nullptr, std::memory_order_acq_rel)};
+    }
+
+    SyntheticFrameSource::SyntheticFrameSource(std::shared_ptr<FrameMailbox> mailbox, SDL_PixelFormatEnum format,
+                                               Size size, uint32_t framesPerSecond)
+            : mMailbox(std::move(mailbox)), mFormat(format), mSize(size),
+              mInterval(1000 / std::max(framesPerSecond, 1u)) {
+        mRunning = true;
+        mThread = std::thread{[this]() { run(); }};
+    }
+
+    SyntheticFrameSource::~SyntheticFrameSource() {
+        mRunning = false;
+        if (mThread.joinable())
+            mThread.join();
+    }
+
+    void SyntheticFrameSource::fillPattern(YuvFrame &frame, uint64_t sequence) {
+        // 75% colour bars, as (U, V), scrolling over a moving luma ramp.
+        static constexpr std::array<std::array<uint8_t, 2>, 8> Bars{{
+                {128, 128}, {44, 142}, {156, 44}, {72, 58}, {184, 198}, {100, 212}, {212, 114}, {128, 128}}};
+
+        auto shift = static_cast<int>(sequence % 256);
+        auto luma = frame.plane(0);
+        for (int y = 0; y < frame.size.h; ++y)
+            for (int x = 0; x < frame.size.w; ++x)
+                luma[y * frame.pitch[0] + x] = static_cast<uint8_t>(16 + (x + y + shift * 4) % 220);
+
+        auto chromaWidth = (frame.size.w + 1) / 2;
+        auto barWidth = std::max(chromaWidth / 8, 1);
+        for (int y = 0; y < frame.rows(1); ++y) {
+            for (int x = 0; x < chromaWidth; ++x) {
+                auto &bar = Bars[static_cast<std::size_t>(((x + shift) / barWidth) % 8)];
+                if (frame.format == SDL_PIXELFORMAT_NV12) {
+                    auto uv = frame.plane(1) + y * frame.pitch[1] + x * 2;
+                    uv[0] = bar[0];
+                    uv[1] = bar[1];
+                } else {
+                    frame.plane(1)[y * frame.pitch[1] + x] = bar[0];
+                    frame.plane(2)[y * frame.pitch[2] + x] = bar[1];
+                }
+            }
+        }
+    }
+
+    void SyntheticFrameSource::run() {
+        auto next = std::chrono::steady_clock::now();
+        for (uint64_t sequence = 0; mRunning; ++sequence) {
+            auto frame = mMailbox->acquire(mFormat, mSize);
+            fillPattern(*frame, sequence);
+            mMailbox->post(std::move(frame));
+            next += std::chrono::milliseconds(mInterval);
+            std::this_thread::sleep_until(next);
+        }
+    }
+
+    void VideoFrame::initialize() {
+        Gadget::initialize();
+        mAnimationSlot = AnimationProtocol::createSlot();
+        mAnimationSlot->receiver = [this](uint64_t) { uploadFrame(); };
+        if (auto application = getApplicationPtr(); application)
+            application->animationSignal.connect(mAnimationSlot);
+    }
+
+    void VideoFrame::uploadFrame() {
+        auto window = getWindow();
+        if (!window)
+            return;
+        auto frame = mMailbox->take();
+        if (!frame)
+            return;
+
+        if (!mTexture || frame->format != mTextureFormat || frame->size != mFrameSize) {
+            mTexture = Texture{window->context(), frame->format, SDL_TEXTUREACCESS_STREAMING, frame->size.w,
+                               frame->size.h};
+            if (!mTexture) {
+                fmt::print("Video frame texture error: {}\n", SDL_GetError());
+                mTextureFormat = SDL_PIXELFORMAT_UNKNOWN;
+                mMailbox->recycle(std::move(frame));
+                return;
+            }
+            mTextureFormat = frame->format;
+            if (frame->size != mFrameSize && !mDeclaredSize)
+                setNeedsLayout();
+            mFrameSize = frame->size;
+        }
+
+        int status;
+        if (frame->format == SDL_PIXELFORMAT_NV12)
+            status = SDL_UpdateNVTexture(mTexture.get(), nullptr, frame->plane(0), frame->pitch[0],
+                                         frame->plane(1), frame->pitch[1]);
+        else
+            status = SDL_UpdateYUVTexture(mTexture.get(), nullptr, frame->plane(0), frame->pitch[0],
+                                          frame->plane(1), frame->pitch[1], frame->plane(2), frame->pitch[2]);
+        if (status)
+            fmt::print("Video frame upload error: {}\n", SDL_GetError());
+
+        mMailbox->recycle(std::move(frame));
+        setNeedsDrawing();
+    }
+
+    bool VideoFrame::initialLayout(Context &context) {
+        mVisualMetrics.desiredSize = mDeclaredSize ? mDeclaredSize : mFrameSize;
+        return Gadget::initialLayout(context);
+    }
+
+    void VideoFrame::draw(Context &context, Point drawLocation) {
+        Gadget::draw(context, drawLocation);
+        auto renderRect = mVisualMetrics.renderRect + drawLocation;
+        if (mTexture) {
+            context.renderCopy(mTexture, renderRect);
+        } else if (mPlaceholderColor) {
+            context.fillRect(renderRect, mPlaceholderColor);
+        }
+    }
+
+} // rose
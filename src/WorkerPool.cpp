@@ -0,0 +1,94 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * WorkerPool.cpp Created by Richard Buckley (C) 18/10/26
+ */
+
+#include "WorkerPool.h"
+#include <algorithm>
+#include <exception>
+#include <fmt/format.h>
+
+namespace rose {
+
+    WorkerPool::WorkerPool(std::size_t threadCount) : mThreadCount(threadCount) {
+        if (mThreadCount == 0) {
+            auto hardware = static_cast<std::size_t>(std::thread::hardware_concurrency());
+            mThreadCount = std::clamp<std::size_t>(hardware > 1 ? hardware - 1 : 1, 1, 4);
+        }
+    }
+
+    WorkerPool::~WorkerPool() {
+        {
+            std::lock_guard lock{mJobMutex};
+            mStop = true;
+            mJobs.clear();
+        }
+        mJobReady.notify_all();
+        for (auto &thread : mThreads)
+            thread.join();
+    }
+
+    void WorkerPool::submit(Job job) {
+        {
+            std::lock_guard lock{mJobMutex};
+            if (mThreads.empty()) {
+                for (std::size_t idx = 0; idx < mThreadCount; ++idx)
+                    mThreads.emplace_back([this]() { worker(); });
+            }
+            mJobs.push_back(std::move(job));
+        }
+        mJobReady.notify_one();
+    }
+
+    void WorkerPool::worker() {
+        while (true) {
+            Job job{};
+            {
+                std::unique_lock lock{mJobMutex};
+                mJobReady.wait(lock, [this]() { return mStop || !mJobs.empty(); });
+                if (mStop)
+                    return;
+                job = std::move(mJobs.front());
+                mJobs.pop_front();
+            }
+
+            try {
+                if (auto completion = job(); completion) {
+                    std::lock_guard lock{mCompletionMutex};
+                    mCompletions.push_back(std::move(completion));
+                }
+            } catch (const std::exception &e) {
+                fmt::print("Worker job error: {}\n", e.what());
+            }
+        }
+    }
+
+    std::size_t WorkerPool::runCompletions(std::chrono::milliseconds budget) {
+        auto start = std::chrono::steady_clock::now();
+        std::size_t count = 0;
+        while (true) {
+            Completion completion{};
+            {
+                std::lock_guard lock{mCompletionMutex};
+                if (mCompletions.empty())
+                    break;
+                completion = std::move(mCompletions.front());
+                mCompletions.pop_front();
+            }
+
+            try {
+                completion();
+            } catch (const std::exception &e) {
+                fmt::print("Worker completion error: {}\n", e.what());
+            }
+            ++count;
+            if (std::chrono::steady_clock::now() - start >= budget)
+                break;
+        }
+        return count;
+    }
+
+} // rose
@@ -0,0 +1,60 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * XDGBaseDir.cpp Created by Richard Buckley (C) 18/10/26
+ */
+
+#include "XDGBaseDir.h"
+#include <cstdlib>
+#include <fmt/format.h>
+
+namespace rose {
+
+    std::filesystem::path xdgCacheHome() {
+        if (auto cacheHome = std::getenv("XDG_CACHE_HOME"); cacheHome != nullptr) {
+            if (std::filesystem::path path{cacheHome}; path.is_absolute())
+                return path;
+        }
+
+        if (auto home = std::getenv("HOME"); home != nullptr && *home != '\0')
+            return std::filesystem::path{home} / ".cache";
+
+        throw XDGPathError("Neither XDG_CACHE_HOME nor HOME is set.");
+    }
+
+    std::filesystem::path roseCacheDirectory(std::string_view subdirectory) {
+        auto path = xdgCacheHome() / "Rose2" / subdirectory;
+        std::error_code ec{};
+        std::filesystem::create_directories(path, ec);
+        if (ec)
+            throw XDGPathError(fmt::format("Can not create cache directory '{}': {}", path.string(), ec.message()));
+        return path;
+    }
+
+    uint64_t fnv1a(std::string_view string) {
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        for (auto c : string) {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 0x100000001b3ULL;
+        }
+        return hash;
+    }
+
+    std::optional<std::string> fileCacheKey(const std::filesystem::path &path) {
+        std::error_code ec{};
+        auto modified = std::filesystem::last_write_time(path, ec);
+        if (ec)
+            return std::nullopt;
+        auto size = std::filesystem::file_size(path, ec);
+        if (ec)
+            return std::nullopt;
+        auto absolute = std::filesystem::absolute(path, ec);
+        if (ec)
+            return std::nullopt;
+        return fmt::format("{:016x}", fnv1a(fmt::format("{}\n{}\n{}", absolute.string(),
+                                                        modified.time_since_epoch().count(), size)));
+    }
+
+} // rose
@@ -14,6 +14,7 @@
  */
 
 #include "manager/RowColumn.h"
+#include <algorithm>
 #include <memory>
 
 namespace rose {
@@ -122,10 +123,46 @@ namespace rose {
                     break;
             }
             result |= widget->immediateGadgetLayout();
+
+            // The space shared among the Gadgets that want a constraint changes with the size of the others.
+            if (auto [fixed, wanting] = fixedMajorSize(getGadgetList(widget)); wanting > 0 && fixed != mFixedMajorSize)
+                result = true;
         } else {
             throw SceneTreeError("rose::LinearLayout can only manage derivatives of rose::Widget");
         }
 
         return result;
     }
+
+    std::pair<ScreenCoordType, int>
+    LinearLayout::fixedMajorSize(const std::vector<std::shared_ptr<Gadget>> &gadgets) const {
+        ScreenCoordType fixed = 0;
+        int wanting = 0;
+        for (auto &gadget: gadgets) {
+            if (gadget->wantsConstraint())
+                ++wanting;
+            else
+                fixed += majorSize(gadget);
+        }
+        return {fixed, wanting};
+    }
+
+    void LinearLayout::constrainedWidgetLayout(Context &context, std::shared_ptr<Widget> &widget, Size interior) {
+        auto gadgets = getGadgetList(widget);
+        auto [fixed, wanting] = fixedMajorSize(gadgets);
+        mFixedMajorSize = fixed;
+
+        auto available = std::max(0, (mMajorAxis == MajorAxis::HORIZONTAL ? interior.w : interior.h) - fixed);
+        auto share = wanting > 0 ? available / wanting : 0;
+        auto remainder = wanting > 0 ? available % wanting : 0;
+        for (auto &gadget: gadgets) {
+            auto major = majorSize(gadget);
+            if (gadget->wantsConstraint()) {
+                major = share + (remainder > 0 ? 1 : 0);
+                --remainder;
+            }
+            gadget->constrainedGadgetLayout(context, mMajorAxis == MajorAxis::HORIZONTAL ?
+                                                     Size{major, interior.h} : Size{interior.w, major});
+        }
+    }
 } // rose
\ No newline at end of file
@@ -17,14 +17,20 @@
 
 namespace rose {
     bool Singlet::initialLayout(Context &context) {
+        bool constraintRequired = false;
         if (mGadget) {
-            mGadget->initialLayout(context);
+            constraintRequired = mGadget->initialLayout(context);
             mVisualMetrics.desiredSize = mGadget->getVisualMetrics().clipRectangle.size;
             Gadget::initialLayout(context);
         }
 
 //        debugLayout(__PRETTY_FUNCTION__ );
-        return false;
+        return constraintRequired;
+    }
+
+    void Singlet::constrainedGadgetLayout(Context &context, Size constraint) {
+        if (mGadget)
+            mGadget->constrainedGadgetLayout(context, interiorConstraint(constraint));
     }
 
     void Singlet::setInternalAlignmentPadding(const Padding &padding) {
@@ -15,6 +15,7 @@
 
 #include "manager/Widget.h"
 #include "Gadget.h"
+#include <algorithm>
 
 namespace rose {
 
@@ -62,6 +63,22 @@ namespace rose {
         }
     }
 
+    void Widget::constrainedGadgetLayout(Context &context, Size constraint) {
+        auto interior = interiorConstraint(constraint);
+        if (mLayoutManager) {
+            auto widget = std::dynamic_pointer_cast<Widget>(shared_from_this());
+            mLayoutManager->constrainedWidgetLayout(context, widget, interior);
+        } else {
+            for (auto &gadget: mGadgetList) {
+                gadget->constrainedGadgetLayout(context, interior);
+            }
+        }
+    }
+
+    bool Widget::wantsConstraint() const {
+        return std::ranges::any_of(mGadgetList, [](const auto &gadget) { return gadget->wantsConstraint(); });
+    }
+
     void Widget::initialize() {
         Gadget::initialize();
         for (auto& gadget : mGadgetList) {
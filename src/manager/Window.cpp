@@ -12,6 +12,14 @@
 
 namespace rose {
 
+    Window::~Window() {
+        // While the Application is destroyed the lock fails, its caches have already been released.
+        if (auto application = mApplicationPtr.lock(); application && mContext) {
+            application->textureCache().purgeRenderer(mContext.get());
+            application->imageCache().purgeRenderer(mContext.get());
+        }
+    }
+
     void Window::layout() {
         /**
          * Layout stage one.
@@ -21,15 +29,18 @@ namespace rose {
             constraintRequired |= screen->initialLayout(context());
         }
 
-        if (constraintRequired) {
+        Size sdlWindowSize{};
+        SDL_GetWindowSize(mSdlWindow.get(), &sdlWindowSize.w, &sdlWindowSize.h);
+        sdlWindowSize.set = true;
+
+        // Gadgets only ask for a constraint they do not have, so a new window size is passed on regardless.
+        if (constraintRequired || (mConstrainedSize && mConstrainedSize != sdlWindowSize)) {
             /**
              * Layout stage two.
              */
-            Size sdlWindowSize{};
-            SDL_GetWindowSize(mSdlWindow.get(), &sdlWindowSize.w, &sdlWindowSize.h);
-            sdlWindowSize.set = true;
             for (const auto &screen: mScreens)
                 screen->constrainedGadgetLayout(context(), sdlWindowSize);
+            mConstrainedSize = sdlWindowSize;
         }
         mNeedsLayout = false;
     }
@@ -54,6 +65,8 @@ namespace rose {
             mFocusChain.push_back(gadget);
             gadget = gadget->manager.lock();
         }
+        if (!mFocusChain.empty())
+            mFocusChain.front()->keyboardFocusEvent(true);
     }
 
     void Window::clearFocusChain() {
@@ -61,9 +74,23 @@ namespace rose {
             gadget->mVisualMetrics.mHasFocus = false;
         }
 
+        if (!mFocusChain.empty())
+            mFocusChain.front()->keyboardFocusEvent(false);
         mFocusChain.clear();
     }
 
+    bool Window::keyboardEvent(const SDL_KeyboardEvent &e) {
+        if (!mFocusChain.empty())
+            return mFocusChain.front()->keyboardEvent(e);
+        return false;
+    }
+
+    bool Window::textInputEvent(const SDL_TextInputEvent &e) {
+        if (!mFocusChain.empty())
+            return mFocusChain.front()->textInputEvent(e);
+        return false;
+    }
+
     [[maybe_unused]] void Window::clearAllFocusFlags() {
         for (auto &screen : mScreens) {
             gadgetTraversal(screen, [](std::shared_ptr<Gadget> &g) { g->mVisualMetrics.mHasFocus = false; });
@@ -216,6 +243,11 @@ namespace rose {
         mVisualMetrics.background = windowPtr->getTheme()->colorShades[ThemeColor::Base];
     }
 
+    void Screen::constrainedGadgetLayout(Context &context, Size constraint) {
+        Widget::constrainedGadgetLayout(context, constraint);
+        initialLayout(context);
+    }
+
     void Screen::changeSize(const Size &size) {
         mVisualMetrics.desiredSize = size;
     }
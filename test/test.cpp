@@ -76,7 +76,7 @@ int main(int argc, char **argv) {
                                 ToggleButton(theme, param::Text{"Toggle"}),
                                 CheckButton(theme, param::Text{"Check"})
                         ),
-                        Build<Image>(theme, imagePath)
+                        Build<Image>(theme, imagePath, param::WatchFile{true})
                 )
         ));
 
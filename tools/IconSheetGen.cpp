@@ -0,0 +1,206 @@
+//
+// Created by richard on 18/10/26.
+//
+
+/*
+ * IconSheetGen.cpp Created by Richard Buckley (C) 18/10/26
+ */
+
+/**
+ * @file IconSheetGen.cpp
+ * @author Richard Buckley <richard.buckley@ieee.org>
+ * @version 1.0
+ * @date 18/10/26
+ * @brief Rasterize a declared list of icons into an IconSheet.
+ * @details Usage:
+ * IconSheetGen --font <font file> --size <points> --list <icon list> --output <base path>
+ *              [--header <header>]... [--codepoints <codepoints file>]
+ *
+ * The icon list has one icon per line, either a code point in hexadecimal (0xe834) or a name. Names are
+ * resolved from the MATERIAL_ constants in MaterialIcons.h, the ENTYPO_ICON_ macros in entypo.h, and a Material
+ * codepoints file, so the names passed to IconGadget::getIcon() can be used as they are. Text after a '#' is
+ * ignored. The sheet is written to base.png and its table to base.bin.
+ */
+
+#include <IconSheet.h>
+#include <SDL_image.h>
+#include <SDL_ttf.h>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <regex>
+#include <string>
+#include <vector>
+
+using namespace rose;
+
+namespace {
+    constexpr int SheetWidth = 1024;    ///< The maximum width of the sheet.
+    constexpr int Gutter = 1;           ///< Transparent pixels between icons.
+
+    using NameMap = std::map<std::string, uint32_t>;
+
+    /**
+     * @brief Read icon names from a header.
+     * @details MATERIAL_name constants are entered as both MATERIAL_name and name, ENTYPO_ICON_ macros by
+     * their full name.
+     */
+    void readHeader(const std::string &path, NameMap &names) {
+        static const std::regex material{R"(constexpr\s+uint32_t\s+MATERIAL_(\w+)\s*=\s*(0x[0-9a-fA-F]+))"};
+        static const std::regex entypo{R"(#define\s+(ENTYPO_ICON_\w+)\s+(0x[0-9a-fA-F]+))"};
+        std::ifstream strm{path};
+        if (!strm)
+            throw IconSheetException(fmt::format("Can not open header '{}'", path));
+
+        for (std::string line; std::getline(strm, line);) {
+            std::smatch match{};
+            if (std::regex_search(line, match, material)) {
+                auto code = static_cast<uint32_t>(std::stoul(match[2].str(), nullptr, 16));
+                names[match[1].str()] = code;
+                names["MATERIAL_" + match[1].str()] = code;
+            } else if (std::regex_search(line, match, entypo)) {
+                names[match[1].str()] = static_cast<uint32_t>(std::stoul(match[2].str(), nullptr, 16));
+            }
+        }
+    }
+
+    /**
+     * @brief Read icon names from a Material codepoints file, lines of "name hex".
+     */
+    void readCodePoints(const std::string &path, NameMap &names) {
+        std::ifstream strm{path};
+        if (!strm)
+            throw IconSheetException(fmt::format("Can not open codepoints file '{}'", path));
+
+        for (std::string line; std::getline(strm, line);) {
+            if (auto pos = line.find(' '); pos != std::string::npos)
+                names.emplace(line.substr(0, pos), static_cast<uint32_t>(std::stoul(line.substr(pos + 1), nullptr, 16)));
+        }
+    }
+
+    /**
+     * @brief Read the icon list, resolving names to code points.
+     */
+    std::vector<uint32_t> readList(const std::string &path, const NameMap &names) {
+        std::ifstream strm{path};
+        if (!strm)
+            throw IconSheetException(fmt::format("Can not open icon list '{}'", path));
+
+        std::vector<uint32_t> codes{};
+        for (std::string line; std::getline(strm, line);) {
+            if (auto hash = line.find('#'); hash != std::string::npos)
+                line.erase(hash);
+            auto first = line.find_first_not_of(" \t\r");
+            if (first == std::string::npos)
+                continue;
+            auto name = line.substr(first, line.find_last_not_of(" \t\r") - first + 1);
+
+            if (name.starts_with("0x") || name.starts_with("0X")) {
+                codes.push_back(static_cast<uint32_t>(std::stoul(name, nullptr, 16)));
+            } else if (auto found = names.find(name); found != names.end()) {
+                codes.push_back(found->second);
+            } else {
+                throw IconSheetException(fmt::format("Icon '{}' not found", name));
+            }
+        }
+
+        std::sort(codes.begin(), codes.end());
+        codes.erase(std::unique(codes.begin(), codes.end()), codes.end());
+        return codes;
+    }
+}
+
+int main(int argc, char **argv) {
+    std::string fontPath{}, listPath{}, outputPath{}, codePointsPath{};
+    std::vector<std::string> headers{};
+    int pointSize{0};
+
+    for (int idx = 1; idx + 1 < argc; idx += 2) {
+        std::string option{argv[idx]};
+        std::string value{argv[idx + 1]};
+        if (option == "--font")
+            fontPath = value;
+        else if (option == "--size")
+            pointSize = std::stoi(value);
+        else if (option == "--list")
+            listPath = value;
+        else if (option == "--output")
+            outputPath = value;
+        else if (option == "--header")
+            headers.push_back(value);
+        else if (option == "--codepoints")
+            codePointsPath = value;
+        else {
+            std::cerr << "Unknown option " << option << '\n';
+            return 1;
+        }
+    }
+
+    if (fontPath.empty() || listPath.empty() || outputPath.empty() || pointSize <= 0) {
+        std::cerr << "Usage: " << argv[0] << " --font <font file> --size <points> --list <icon list>"
+                  << " --output <base path> [--header <header>]... [--codepoints <codepoints file>]\n";
+        return 1;
+    }
+
+    try {
+        NameMap names{};
+        for (const auto &header : headers)
+            readHeader(header, names);
+        if (!codePointsPath.empty())
+            readCodePoints(codePointsPath, names);
+        auto codes = readList(listPath, names);
+
+        if (TTF_Init())
+            throw IconSheetException(fmt::format("TTF_Init: {}", SDL_GetError()));
+        auto font = TTF_OpenFont(fontPath.c_str(), pointSize);
+        if (!font)
+            throw IconSheetException(fmt::format("TTF_OpenFont: {}", SDL_GetError()));
+
+        std::vector<Surface> glyphs{};
+        std::vector<IconSheet::Entry> entries{};
+        int x = 0, y = 0, shelfHeight = 0, width = 1;
+        for (auto code : codes) {
+            Surface glyph{TTF_RenderGlyph32_Blended(font, code, SDL_Color{255, 255, 255, 255})};
+            if (!glyph) {
+                std::cerr << fmt::format("Icon {:#x} can not be rendered: {}\n", code, SDL_GetError());
+                continue;
+            }
+            if (x + glyph->w > SheetWidth && x > 0) {
+                x = 0;
+                y += shelfHeight + Gutter;
+                shelfHeight = 0;
+            }
+            entries.push_back(IconSheet::Entry{code, static_cast<uint16_t>(x), static_cast<uint16_t>(y),
+                                               static_cast<uint16_t>(glyph->w), static_cast<uint16_t>(glyph->h)});
+            x += glyph->w + Gutter;
+            width = std::max(width, x);
+            shelfHeight = std::max(shelfHeight, glyph->h);
+            glyphs.push_back(std::move(glyph));
+        }
+        TTF_CloseFont(font);
+
+        Surface sheet{width, std::max(1, y + shelfHeight)};
+        SDL_FillRect(sheet.get(), nullptr, SDL_MapRGBA(sheet->format, 255, 255, 255, 0));
+        for (std::size_t idx = 0; idx < glyphs.size(); ++idx) {
+            SDL_SetSurfaceBlendMode(glyphs[idx].get(), SDL_BLENDMODE_NONE);
+            SDL_Rect dst{entries[idx].x, entries[idx].y, entries[idx].w, entries[idx].h};
+            SDL_BlitSurface(glyphs[idx].get(), nullptr, sheet.get(), &dst);
+        }
+
+        std::filesystem::path base{outputPath};
+        auto imagePath = base;
+        imagePath.replace_extension("png");
+        if (IMG_SavePNG(sheet.get(), imagePath.c_str()))
+            throw IconSheetException(fmt::format("IMG_SavePNG: {}", IMG_GetError()));
+        auto tablePath = base;
+        tablePath.replace_extension("bin");
+        IconSheet::writeTable(tablePath, pointSize, std::move(entries));
+
+        TTF_Quit();
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+    return 0;
+}